@@ -0,0 +1,167 @@
+#include <novo-core/JobSystem.hpp>
+#include <novo-core/SceneFile.hpp>
+#include <novo-core/MappedFile.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+template <typename Function>
+double measure_ms(Function&& function) {
+    const auto start = Clock::now();
+    function();
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void report(const std::string& name, double ms, size_t operations) {
+    std::cout << std::left << std::setw(40) << name
+              << std::right << std::setw(10) << std::fixed << std::setprecision(3) << ms << " ms"
+              << std::setw(12) << std::setprecision(1) << ms * 1e6 / operations << " ns/op" << std::endl;
+}
+
+/// Submits empty jobs from the main thread and waits on a counter
+void bench_empty_jobs(Novo::JobSystem& jobs, size_t count) {
+    auto counter = jobs.make_counter();
+    const double ms = measure_ms([&] {
+        for (size_t i = 0; i < count; ++i) {
+            jobs.submit([] {}, counter);
+        }
+        jobs.wait(counter);
+    });
+    report("empty jobs (submit + run)", ms, count);
+}
+
+/// One job spawns every other job, so the rest of the pool only gets work by stealing
+void bench_stealing(Novo::JobSystem& jobs, size_t count) {
+    auto counter = jobs.make_counter();
+    const double ms = measure_ms([&] {
+        jobs.submit([&] {
+            for (size_t i = 0; i < count; ++i) {
+                jobs.submit([] {}, counter);
+            }
+        }, counter);
+        jobs.wait(counter);
+    });
+    report("empty jobs spawned by one worker", ms, count);
+}
+
+/// Each job depends on the previous one, measures continuation latency
+void bench_dependency_chain(Novo::JobSystem& jobs, size_t length) {
+    const double ms = measure_ms([&] {
+        auto previous = jobs.make_counter();
+        jobs.submit([] {}, previous);
+        for (size_t i = 1; i < length; ++i) {
+            auto next = jobs.make_counter();
+            jobs.submit_after(previous, [] {}, next);
+            previous = next;
+        }
+        jobs.wait(previous);
+    });
+    report("dependency chain link", ms, length);
+}
+
+/// Main thread pinned jobs submitted from workers
+void bench_main_jobs(Novo::JobSystem& jobs, size_t count) {
+    auto counter = jobs.make_counter();
+    const double ms = measure_ms([&] {
+        jobs.parallel_for(count, 1024, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                jobs.submit_main([] {}, counter);
+            }
+        });
+        jobs.wait(counter);
+    });
+    report("main thread jobs", ms, count);
+}
+
+/// parallel_for overhead compared with a plain loop over the same work
+void bench_parallel_for(Novo::JobSystem& jobs, size_t count) {
+    std::vector<float> data(count, 2.f);
+    auto work = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            data[i] = std::sqrt(data[i] + 1.f);
+        }
+    };
+
+    const double serial = measure_ms([&] { work(0, count); });
+    report("serial loop", serial, count);
+
+    for (size_t grain : { 256, 1024, 4096, 16384, 65536 }) {
+        const double parallel = measure_ms([&] { jobs.parallel_for(count, grain, work); });
+        report("parallel_for grain " + std::to_string(grain), parallel, count);
+    }
+}
+
+/// Reading every object field of a generated scene from JSON text and from a mapped binary scene file
+void bench_scene_formats(size_t count) {
+    using Json = nlohmann::json;
+
+    Json json;
+    json["name"] = "bench";
+    json["shaders"] = { { {"name", "ObjShader"}, {"vs", "object.vert"}, {"fs", "object.frag"} } };
+    json["materials"] = { { {"name", "BoxMaterial"}, {"path", "box_material.json"} } };
+    json["textures"] = { { {"name", "Box"}, {"path", "box_texture.png"} } };
+    json["objects"] = Json::array();
+    for (size_t i = 0; i < count; ++i) {
+        const float f = static_cast<float>(i);
+        json["objects"].push_back({
+            {"name", "Box " + std::to_string(i)}, {"type.id", 1}, {"shader", "ObjShader"}, {"material", "BoxMaterial"}, {"texture", "Box"},
+            {"uv.x", 1.f}, {"uv.y", 1.f},
+            {"transform", {
+                {"position", { {"x", f}, {"y", 0.f}, {"z", -f} }},
+                {"rotation", { {"x", 0.f}, {"y", f}, {"z", 0.f} }},
+                {"scale", { {"x", 1.f}, {"y", 1.f}, {"z", 1.f} }}
+            }},
+            {"other", Json::object()}
+        });
+    }
+    const std::string text = json.dump();
+
+    Novo::SceneFile::Writer writer;
+    Novo::SceneFile::from_json(json, writer);
+    const std::string path = "novo-bench-scene.nvscene";
+    writer.write(path);
+
+    float checksum = 0.f;
+    const double json_ms = measure_ms([&] {
+        Json parsed = Json::parse(text);
+        for (auto& obj : parsed["objects"]) {
+            checksum += obj["transform"]["position"]["x"].get<float>() + obj["transform"]["rotation"]["y"].get<float>();
+            checksum += static_cast<float>(obj["name"].get<std::string>().size());
+        }
+    });
+    report("scene load, JSON", json_ms, count);
+
+    const double binary_ms = measure_ms([&] {
+        Novo::MappedFile file(path);
+        const Novo::SceneFile::View view(file.get_data(), file.get_size());
+        for (const auto& obj : view.get_objects()) {
+            checksum += obj.position[0] + obj.rotation[1];
+            checksum += static_cast<float>(view.get_string(obj.name).size());
+        }
+    });
+    report("scene load, mapped binary", binary_ms, count);
+
+    std::remove(path.c_str());
+    if (checksum == 0.f) std::cout << std::endl; // Keeps the loops from being optimized out
+}
+
+int main(int argc, char const *argv[]) {
+    const size_t threads = argc > 1 ? std::stoul(argv[1]) : std::max(1u, std::thread::hardware_concurrency()) - 1;
+    Novo::JobSystem jobs(threads);
+    std::cout << "Worker threads: " << jobs.get_thread_count() << std::endl;
+
+    bench_empty_jobs(jobs, 1000000);
+    bench_stealing(jobs, 1000000);
+    bench_dependency_chain(jobs, 100000);
+    bench_main_jobs(jobs, 100000);
+    bench_parallel_for(jobs, 1 << 24);
+    bench_scene_formats(100000);
+    return 0;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <utility>
+
+namespace Novo {
+    /// Axis aligned bounding box
+    struct AABB {
+        glm::vec3 min = glm::vec3(0.f);
+        glm::vec3 max = glm::vec3(0.f);
+
+        glm::vec3 get_center() const {
+            return (min + max) * 0.5f;
+        }
+
+        glm::vec3 get_extents() const {
+            return (max - min) * 0.5f;
+        }
+
+        float get_surface_area() const {
+            const glm::vec3 size = max - min;
+            return 2.f * (size.x * size.y + size.y * size.z + size.z * size.x);
+        }
+
+        bool contains(const AABB& other) const {
+            return min.x <= other.min.x && min.y <= other.min.y && min.z <= other.min.z &&
+                   max.x >= other.max.x && max.y >= other.max.y && max.z >= other.max.z;
+        }
+
+        bool overlaps(const AABB& other) const {
+            return min.x <= other.max.x && min.y <= other.max.y && min.z <= other.max.z &&
+                   max.x >= other.min.x && max.y >= other.min.y && max.z >= other.min.z;
+        }
+
+        /// Slab test. `inv_direction` is 1 / direction, so axis-parallel rays work through infinities
+        /// @return true and the entry distance in `t` if the ray hits the box before `t_max`
+        bool intersects_ray(const glm::vec3& origin, const glm::vec3& inv_direction, float t_max, float& t) const {
+            float t_min = 0.f;
+            for (int i = 0; i < 3; ++i) {
+                float t0 = (min[i] - origin[i]) * inv_direction[i];
+                float t1 = (max[i] - origin[i]) * inv_direction[i];
+                if (t0 > t1) std::swap(t0, t1);
+                t_min = t0 > t_min ? t0 : t_min;
+                t_max = t1 < t_max ? t1 : t_max;
+                if (t_min > t_max) return false;
+            }
+            t = t_min;
+            return true;
+        }
+
+        AABB expand(float margin) const {
+            return { min - glm::vec3(margin), max + glm::vec3(margin) };
+        }
+
+        static AABB merge(const AABB& a, const AABB& b) {
+            return { glm::min(a.min, b.min), glm::max(a.max, b.max) };
+        }
+
+        /// Bounds of this box after transforming it by `matrix`
+        AABB transform(const glm::mat4& matrix) const {
+            const glm::vec3 center = glm::vec3(matrix * glm::vec4(get_center(), 1.f));
+            const glm::vec3 extents = get_extents();
+
+            glm::vec3 new_extents = glm::vec3(0.f);
+            for (int i = 0; i < 3; ++i) {
+                new_extents += glm::abs(glm::vec3(matrix[i])) * extents[i];
+            }
+            return { center - new_extents, center + new_extents };
+        }
+    };
+}
@@ -5,11 +5,13 @@
 #include <novo-core/VBO.hpp>
 #include <novo-core/VAO.hpp>
 #include <novo-core/IBO.hpp>
+#include <novo-core/SSBO.hpp>
 #include <novo-core/Texture2D.hpp>
 #include <novo-core/Camera.hpp>
 #include <novo-core/CurrentCamera.hpp>
 #include <novo-core/Resources.hpp>
 #include <novo-core/Scene.hpp>
+#include <novo-core/JobSystem.hpp>
 #include <novo-core/Material.hpp>
 
 #include <novo-core/Mesh/Box.hpp>
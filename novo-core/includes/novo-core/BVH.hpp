@@ -0,0 +1,405 @@
+#pragma once
+
+#include <novo-core/AABB.hpp>
+#include <novo-core/Frustum.hpp>
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace Novo {
+    /// Dynamic bounding volume hierarchy over object bounds.
+    /// Nodes live in one array and refer to each other by index, freed nodes are reused through a free list.
+    /// Leaves store bounds fattened by a margin, so small movements don't touch the tree at all
+    class BVH {
+    public:
+        static constexpr int32_t NULL_NODE = -1;
+
+        /// Working memory of frustum queries, kept by the caller so repeated queries don't allocate
+        struct FrustumScratch {
+            std::vector<int32_t> stack;
+            BoundsList leaf_bounds;          // Leaves reached by the traversal, tested together with Frustum::cull()
+            std::vector<uint32_t> leaf_data;
+            std::vector<uint8_t> visible;
+        };
+    private:
+        struct Node {
+            AABB bounds;
+            int32_t parent = NULL_NODE; // Next free node while the node is in the free list
+            int32_t left = NULL_NODE;
+            int32_t right = NULL_NODE;
+            int32_t height = 0;         // 0 - leaf, -1 - free
+            uint32_t user_data = 0;
+
+            bool is_leaf() const { return left == NULL_NODE; }
+        };
+
+        std::vector<Node> _nodes;
+        int32_t _root = NULL_NODE;
+        int32_t _free = NULL_NODE;
+        size_t _leaf_count = 0;
+        float _margin;
+
+        mutable std::vector<int32_t> _stack; // Reused by queries to avoid allocating every call
+        mutable FrustumScratch _frustum_scratch;
+
+        int32_t allocate_node() {
+            if (_free == NULL_NODE) {
+                _nodes.emplace_back();
+                return static_cast<int32_t>(_nodes.size() - 1);
+            }
+            int32_t index = _free;
+            _free = _nodes[index].parent;
+            _nodes[index] = Node();
+            return index;
+        }
+
+        void free_node(int32_t index) {
+            _nodes[index].parent = _free;
+            _nodes[index].height = -1;
+            _free = index;
+        }
+
+        void replace_child(int32_t parent, int32_t old_child, int32_t new_child) {
+            if (parent == NULL_NODE) {
+                _root = new_child;
+            } else if (_nodes[parent].left == old_child) {
+                _nodes[parent].left = new_child;
+            } else {
+                _nodes[parent].right = new_child;
+            }
+        }
+
+        /// Surface area heuristic: descend towards the child whose bounds grow the least
+        int32_t find_sibling(const AABB& box) const {
+            int32_t index = _root;
+            while (!_nodes[index].is_leaf()) {
+                const Node& node = _nodes[index];
+                const float area = node.bounds.get_surface_area();
+                const float combined_area = AABB::merge(node.bounds, box).get_surface_area();
+
+                const float cost = 2.f * combined_area;            // Cost of pairing the new leaf with this node
+                const float inheritance = 2.f * (combined_area - area); // Cost pushed down to every level below
+
+                auto descend_cost = [&](int32_t child) {
+                    const AABB merged = AABB::merge(_nodes[child].bounds, box);
+                    if (_nodes[child].is_leaf()) return merged.get_surface_area() + inheritance;
+                    return merged.get_surface_area() - _nodes[child].bounds.get_surface_area() + inheritance;
+                };
+
+                const float left_cost = descend_cost(node.left);
+                const float right_cost = descend_cost(node.right);
+                if (cost < left_cost && cost < right_cost) break;
+
+                index = left_cost < right_cost ? node.left : node.right;
+            }
+            return index;
+        }
+
+        void insert_leaf(int32_t leaf) {
+            if (_root == NULL_NODE) {
+                _root = leaf;
+                _nodes[leaf].parent = NULL_NODE;
+                return;
+            }
+
+            const int32_t sibling = find_sibling(_nodes[leaf].bounds);
+            const int32_t old_parent = _nodes[sibling].parent;
+            const int32_t new_parent = allocate_node();
+
+            Node& parent = _nodes[new_parent];
+            parent.parent = old_parent;
+            parent.left = sibling;
+            parent.right = leaf;
+            parent.bounds = AABB::merge(_nodes[sibling].bounds, _nodes[leaf].bounds);
+            parent.height = _nodes[sibling].height + 1;
+
+            replace_child(old_parent, sibling, new_parent);
+            _nodes[sibling].parent = new_parent;
+            _nodes[leaf].parent = new_parent;
+
+            refit(new_parent);
+        }
+
+        void remove_leaf(int32_t leaf) {
+            if (leaf == _root) {
+                _root = NULL_NODE;
+                return;
+            }
+
+            const int32_t parent = _nodes[leaf].parent;
+            const int32_t grand_parent = _nodes[parent].parent;
+            const int32_t sibling = _nodes[parent].left == leaf ? _nodes[parent].right : _nodes[parent].left;
+
+            replace_child(grand_parent, parent, sibling);
+            _nodes[sibling].parent = grand_parent;
+            free_node(parent);
+
+            if (grand_parent != NULL_NODE) refit(grand_parent);
+        }
+
+        /// Recomputes bounds and heights from `index` up to the root, rebalancing on the way
+        void refit(int32_t index) {
+            while (index != NULL_NODE) {
+                index = balance(index);
+
+                Node& node = _nodes[index];
+                node.height = 1 + std::max(_nodes[node.left].height, _nodes[node.right].height);
+                node.bounds = AABB::merge(_nodes[node.left].bounds, _nodes[node.right].bounds);
+
+                index = node.parent;
+            }
+        }
+
+        /// Rotates the taller child of `index` up if the subtree is unbalanced
+        /// @return index of the node now at the subtree root
+        int32_t balance(int32_t index) {
+            const Node& node = _nodes[index];
+            if (node.is_leaf() || node.height < 2) return index;
+
+            const int32_t skew = _nodes[node.right].height - _nodes[node.left].height;
+            if (skew > 1) return rotate(index, node.right, node.left);
+            if (skew < -1) return rotate(index, node.left, node.right);
+            return index;
+        }
+
+        /// Moves `up` (a child of `index`) into the place of `index`. The shorter child of `up` goes down to `index`
+        int32_t rotate(int32_t index, int32_t up, int32_t other) {
+            const int32_t first = _nodes[up].left;
+            const int32_t second = _nodes[up].right;
+
+            _nodes[up].parent = _nodes[index].parent;
+            replace_child(_nodes[up].parent, index, up);
+            _nodes[index].parent = up;
+            _nodes[up].left = index;
+
+            int32_t keep = first, move = second;
+            if (_nodes[first].height < _nodes[second].height) std::swap(keep, move);
+
+            _nodes[up].right = keep;
+            if (_nodes[index].left == up) {
+                _nodes[index].left = move;
+            } else {
+                _nodes[index].right = move;
+            }
+            _nodes[move].parent = index;
+
+            _nodes[index].bounds = AABB::merge(_nodes[other].bounds, _nodes[move].bounds);
+            _nodes[index].height = 1 + std::max(_nodes[other].height, _nodes[move].height);
+            _nodes[up].bounds = AABB::merge(_nodes[index].bounds, _nodes[keep].bounds);
+            _nodes[up].height = 1 + std::max(_nodes[index].height, _nodes[keep].height);
+
+            return up;
+        }
+
+        /// Calls `callback` with every leaf under `index` without testing bounds
+        template <typename Callback>
+        void collect(int32_t index, std::vector<int32_t>& stack, Callback& callback) const {
+            const size_t stack_base = stack.size();
+            stack.push_back(index);
+            while (stack.size() > stack_base) {
+                const Node& node = _nodes[stack.back()];
+                stack.pop_back();
+                if (node.is_leaf()) {
+                    callback(node.user_data);
+                } else {
+                    stack.push_back(node.left);
+                    stack.push_back(node.right);
+                }
+            }
+        }
+    public:
+        /// @param margin how far leaf bounds are fattened, objects moving less than that are not reinserted
+        explicit BVH(float margin = 0.1f) : _margin(margin) {}
+
+        /// @return proxy used to move or destroy the leaf later
+        int32_t create_proxy(const AABB& box, uint32_t user_data) {
+            const int32_t leaf = allocate_node();
+            _nodes[leaf].bounds = box.expand(_margin);
+            _nodes[leaf].user_data = user_data;
+            insert_leaf(leaf);
+            ++_leaf_count;
+            return leaf;
+        }
+
+        void destroy_proxy(int32_t proxy) {
+            remove_leaf(proxy);
+            free_node(proxy);
+            --_leaf_count;
+        }
+
+        /// Updates the bounds of a leaf. The tree only changes if `box` left the fattened bounds
+        /// @return true if the leaf was reinserted
+        bool move_proxy(int32_t proxy, const AABB& box) {
+            if (_nodes[proxy].bounds.contains(box)) return false;
+
+            remove_leaf(proxy);
+            _nodes[proxy].bounds = box.expand(_margin);
+            insert_leaf(proxy);
+            return true;
+        }
+
+        uint32_t get_user_data(int32_t proxy) const {
+            return _nodes[proxy].user_data;
+        }
+
+        const AABB& get_fat_bounds(int32_t proxy) const {
+            return _nodes[proxy].bounds;
+        }
+
+        /// Frustum query of the subtree under `root` using the caller's scratch, so several threads can query disjoint subtrees.
+        /// Inner nodes are classified one by one, the leaves below intersecting nodes are gathered and culled in one SoA pass
+        template <typename Callback>
+        void query(int32_t root, const Frustum& frustum, FrustumScratch& scratch, Callback&& callback) const {
+            if (root == NULL_NODE) return;
+
+            std::vector<int32_t>& stack = scratch.stack;
+            const size_t stack_base = stack.size();
+            const size_t leaf_base = scratch.leaf_data.size();
+            stack.push_back(root);
+            while (stack.size() > stack_base) {
+                const int32_t index = stack.back();
+                stack.pop_back();
+
+                const Node& node = _nodes[index];
+                if (node.is_leaf()) {
+                    scratch.leaf_bounds.push(node.bounds);
+                    scratch.leaf_data.push_back(node.user_data);
+                    continue;
+                }
+
+                const Frustum::Test test = frustum.classify(node.bounds);
+                if (test == Frustum::Test::Outside) continue;
+
+                if (test == Frustum::Test::Inside) {
+                    collect(index, stack, callback);
+                } else {
+                    stack.push_back(node.left);
+                    stack.push_back(node.right);
+                }
+            }
+
+            // Indexed from the base, a callback may run a nested query that appends behind it
+            const size_t leaf_end = scratch.leaf_data.size();
+            scratch.visible.resize(leaf_end);
+            frustum.cull(scratch.leaf_bounds, leaf_base, leaf_end - leaf_base, scratch.visible.data() + leaf_base);
+            for (size_t i = leaf_base; i < leaf_end; ++i) {
+                if (scratch.visible[i]) callback(scratch.leaf_data[i]);
+            }
+            scratch.leaf_bounds.truncate(leaf_base);
+            scratch.leaf_data.resize(leaf_base);
+            scratch.visible.resize(leaf_base);
+        }
+
+        /// Calls `callback(user_data)` for every leaf intersecting the frustum. Subtrees fully inside are not tested further
+        /// @warning The tree must not be modified from the callback
+        template <typename Callback>
+        void query(const Frustum& frustum, Callback&& callback) const {
+            query(_root, frustum, _frustum_scratch, callback);
+        }
+
+        /// Splits the tree into at least `count` disjoint subtrees (fewer if there are not enough nodes), breadth first.
+        /// Containment makes testing only the subtree roots equivalent to testing the whole path from the root
+        void split(size_t count, std::vector<int32_t>& roots) const {
+            roots.clear();
+            if (_root == NULL_NODE) return;
+
+            // roots[0, kept) are leaves reached so far, roots[head, end) is the FIFO queue of subtrees still to split
+            size_t kept = 0;
+            size_t head = 0;
+            roots.push_back(_root);
+            while (head < roots.size() && kept + roots.size() - head < count) {
+                const int32_t index = roots[head++];
+                const Node& node = _nodes[index];
+                if (node.is_leaf()) {
+                    roots[kept++] = index;
+                    continue;
+                }
+                roots.push_back(node.left);
+                roots.push_back(node.right);
+            }
+            roots.erase(roots.begin() + kept, roots.begin() + head);
+        }
+
+        /// Calls `callback(user_data)` for every leaf whose fattened bounds overlap `box`
+        /// @warning The tree must not be modified from the callback
+        template <typename Callback>
+        void query(const AABB& box, Callback&& callback) const {
+            if (_root == NULL_NODE) return;
+
+            const size_t stack_base = _stack.size();
+            _stack.push_back(_root);
+            while (_stack.size() > stack_base) {
+                const Node& node = _nodes[_stack.back()];
+                _stack.pop_back();
+
+                if (!node.bounds.overlaps(box)) continue;
+
+                if (node.is_leaf()) {
+                    callback(node.user_data);
+                } else {
+                    _stack.push_back(node.left);
+                    _stack.push_back(node.right);
+                }
+            }
+        }
+
+        /// Walks the leaves hit by the ray. `callback(user_data, max_distance)` returns the distance of its own exact hit,
+        /// or a negative value on a miss. Closer hits shrink the search, so far subtrees are skipped
+        /// @return distance of the closest hit, negative if nothing was hit
+        template <typename Callback>
+        float raycast(const glm::vec3& origin, const glm::vec3& direction, float max_distance, Callback&& callback) const {
+            if (_root == NULL_NODE) return -1.f;
+
+            const glm::vec3 inv_direction = glm::vec3(1.f / direction.x, 1.f / direction.y, 1.f / direction.z);
+            float closest = -1.f;
+
+            const size_t stack_base = _stack.size();
+            _stack.push_back(_root);
+            while (_stack.size() > stack_base) {
+                const Node& node = _nodes[_stack.back()];
+                _stack.pop_back();
+
+                float t;
+                if (!node.bounds.intersects_ray(origin, inv_direction, max_distance, t)) continue;
+
+                if (node.is_leaf()) {
+                    const float hit = callback(node.user_data, max_distance);
+                    if (hit >= 0.f && hit <= max_distance) {
+                        max_distance = hit;
+                        closest = hit;
+                    }
+                } else {
+                    _stack.push_back(node.left);
+                    _stack.push_back(node.right);
+                }
+            }
+            return closest;
+        }
+
+        void clear() {
+            _nodes.clear();
+            _root = NULL_NODE;
+            _free = NULL_NODE;
+            _leaf_count = 0;
+        }
+
+        size_t get_leaf_count() const {
+            return _leaf_count;
+        }
+
+        size_t get_node_count() const {
+            return _nodes.size();
+        }
+
+        int32_t get_height() const {
+            return _root == NULL_NODE ? 0 : _nodes[_root].height;
+        }
+
+        void set_margin(float margin) {
+            _margin = margin;
+        }
+    };
+}
@@ -6,6 +6,8 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtx/euler_angles.hpp>
 
+#include <novo-core/Frustum.hpp>
+
 namespace Novo {
     class Camera {
     public: enum class CameraType;
@@ -104,6 +106,15 @@ namespace Novo {
             return _proj_matrix * _view_matrix;
         }
 
+        Frustum get_frustum() const {
+            return Frustum(get_view_proj_matrix());
+        }
+
+        /// Left, right, bottom, top, near and far planes in world space. XYZ - inward normal, W - distance
+        std::array<glm::vec4, 6> get_frustum_planes() const {
+            return get_frustum().get_planes();
+        }
+
         void set_fov(const float fov) {
             _fov = fov;
             update_proj_matrix(_type);
@@ -139,5 +150,25 @@ namespace Novo {
         const glm::vec3& get_rotation() const {
             return _rotation;
         }
+
+        CameraType get_projection_mode() const {
+            return _type;
+        }
+
+        float get_fov() const {
+            return _fov;
+        }
+
+        float get_aspect_ratio() const {
+            return _aspect_ratio;
+        }
+
+        float get_near() const {
+            return _near;
+        }
+
+        float get_far() const {
+            return _far;
+        }
     };
 }
\ No newline at end of file
@@ -0,0 +1,202 @@
+#pragma once
+
+#include <novo-core/SSBO.hpp>
+#include <novo-core/Camera.hpp>
+#include <novo-core/LightBuffer.hpp>
+#include <novo-core/AABB.hpp>
+#include <glm/glm.hpp>
+#include <vector>
+#include <cmath>
+#include <cstring>
+
+namespace Novo {
+    /// Clustered forward lighting. The view frustum is split into GRID_X * GRID_Y screen tiles
+    /// and GRID_Z exponential depth slices, every light is binned into the clusters its sphere
+    /// touches, and object.frag only walks the list of the cluster a fragment falls into.
+    ///
+    /// GPU layout: `ClusterGrid` at binding 1 (header + offset/count per cluster) and
+    /// `ClusterLights` at binding 2 (light indices into LightBuffer).
+    class ClusterGrid {
+    public:
+        static constexpr GLuint GRID_BINDING = 1;
+        static constexpr GLuint INDICES_BINDING = 2;
+
+        static constexpr GLuint GRID_X = 16;
+        static constexpr GLuint GRID_Y = 9;
+        static constexpr GLuint GRID_Z = 24;
+        static constexpr GLuint CLUSTER_COUNT = GRID_X * GRID_Y * GRID_Z;
+    private:
+        struct Header {
+            glm::uvec4 grid_size;   // XYZ - clusters per axis
+            glm::vec4 z_params;     // X - slice scale, Y - slice bias
+            glm::vec4 screen_size;  // XY - viewport size in pixels
+            glm::mat4 view;
+        };
+
+        std::vector<AABB> _bounds;          // View space bounds of every cluster
+        std::vector<glm::uvec2> _clusters;  // X - offset into _indices, Y - light count
+        std::vector<GLuint> _indices;
+        std::vector<glm::uvec2> _hits;      // X - cluster, Y - light. Scratch for binning
+
+        glm::mat4 _proj = glm::mat4(0.f);
+        float _near = 0.f;
+        float _far = 0.f;
+        float _slice_scale = 0.f;
+        float _slice_bias = 0.f;
+
+        SSBO _grid;
+        SSBO _lightIndices;
+
+        GLuint index(GLuint x, GLuint y, GLuint z) const {
+            return x + GRID_X * (y + GRID_Y * z);
+        }
+
+        float slice_depth(GLuint slice) const {
+            return _near * std::pow(_far / _near, static_cast<float>(slice) / GRID_Z);
+        }
+
+        static glm::vec3 unproject(const glm::mat4& inv_proj, float x, float y, float z) {
+            glm::vec4 point = inv_proj * glm::vec4(x, y, z, 1.f);
+            return glm::vec3(point) / point.w;
+        }
+
+        /// Point at view space depth `depth` on the ray that goes through NDC (x, y)
+        static glm::vec3 at_depth(const glm::mat4& inv_proj, float x, float y, float depth) {
+            glm::vec3 near_point = unproject(inv_proj, x, y, -1.f);
+            glm::vec3 far_point = unproject(inv_proj, x, y, 1.f);
+            float t = (-depth - near_point.z) / (far_point.z - near_point.z);
+            return near_point + (far_point - near_point) * t;
+        }
+
+        void rebuild_bounds(const Camera& camera) {
+            _proj = camera.get_proj_matrix();
+            _near = camera.get_near();
+            _far = camera.get_far();
+
+            const float log_ratio = std::log(_far / _near);
+            _slice_scale = GRID_Z / log_ratio;
+            _slice_bias = -(GRID_Z * std::log(_near)) / log_ratio;
+
+            const glm::mat4 inv_proj = glm::inverse(_proj);
+            _bounds.resize(CLUSTER_COUNT);
+            for (GLuint z = 0; z < GRID_Z; ++z) {
+                float depth_near = slice_depth(z);
+                float depth_far = slice_depth(z + 1);
+                for (GLuint y = 0; y < GRID_Y; ++y) {
+                    float y0 = -1.f + 2.f * y / GRID_Y;
+                    float y1 = -1.f + 2.f * (y + 1) / GRID_Y;
+                    for (GLuint x = 0; x < GRID_X; ++x) {
+                        float x0 = -1.f + 2.f * x / GRID_X;
+                        float x1 = -1.f + 2.f * (x + 1) / GRID_X;
+
+                        AABB box = { glm::vec3(INFINITY), glm::vec3(-INFINITY) };
+                        for (float depth : {depth_near, depth_far}) {
+                            for (const glm::vec3& corner : {
+                                at_depth(inv_proj, x0, y0, depth), at_depth(inv_proj, x1, y0, depth),
+                                at_depth(inv_proj, x0, y1, depth), at_depth(inv_proj, x1, y1, depth) }) {
+                                box.min = glm::min(box.min, corner);
+                                box.max = glm::max(box.max, corner);
+                            }
+                        }
+                        _bounds[index(x, y, z)] = box;
+                    }
+                }
+            }
+        }
+
+        GLuint slice_of(float depth) const {
+            if (depth <= _near) return 0;
+            float slice = std::log(depth) * _slice_scale + _slice_bias;
+            return static_cast<GLuint>(glm::clamp(slice, 0.f, static_cast<float>(GRID_Z - 1)));
+        }
+
+        static bool intersects(const AABB& box, const glm::vec3& center, float radius) {
+            glm::vec3 closest = glm::max(box.min, glm::min(center, box.max));
+            glm::vec3 delta = closest - center;
+            return glm::dot(delta, delta) <= radius * radius;
+        }
+    public:
+        ClusterGrid()
+            : _grid(GRID_BINDING, sizeof(Header) + CLUSTER_COUNT * sizeof(glm::uvec2)),
+              _lightIndices(INDICES_BINDING, sizeof(GLuint)) {
+            _clusters.resize(CLUSTER_COUNT);
+        }
+
+        /// Bins `lights` into clusters of `camera`'s frustum and uploads the result
+        void build(const Camera& camera, const std::vector<LightBuffer::LightData>& lights, const glm::vec2& screen_size) {
+            const glm::mat4 proj = camera.get_proj_matrix();
+            if (_bounds.empty() || std::memcmp(&proj, &_proj, sizeof(glm::mat4)) != 0 ||
+                camera.get_near() != _near || camera.get_far() != _far) {
+                rebuild_bounds(camera);
+            }
+
+            const glm::mat4 view = camera.get_view_matrix();
+
+            _hits.clear();
+            for (GLuint i = 0; i < lights.size(); ++i) {
+                const float radius = lights[i].position.w;
+                const glm::vec3 center = glm::vec3(view * glm::vec4(glm::vec3(lights[i].position), 1.f));
+                const float depth = -center.z;
+                if (radius <= 0.f || depth + radius < _near || depth - radius > _far) continue;
+
+                const GLuint first = slice_of(depth - radius);
+                const GLuint last = slice_of(depth + radius);
+                for (GLuint z = first; z <= last; ++z) {
+                    for (GLuint y = 0; y < GRID_Y; ++y) {
+                        for (GLuint x = 0; x < GRID_X; ++x) {
+                            GLuint cluster = index(x, y, z);
+                            if (intersects(_bounds[cluster], center, radius)) {
+                                _hits.emplace_back(cluster, i);
+                            }
+                        }
+                    }
+                }
+            }
+
+            // Counting sort of the hits by cluster
+            for (auto& cluster : _clusters) {
+                cluster = glm::uvec2(0, 0);
+            }
+            for (auto& hit : _hits) {
+                ++_clusters[hit.x].y;
+            }
+            GLuint offset = 0;
+            for (auto& cluster : _clusters) {
+                cluster.x = offset;
+                offset += cluster.y;
+                cluster.y = 0;
+            }
+            _indices.resize(std::max<size_t>(_hits.size(), 1));
+            for (auto& hit : _hits) {
+                glm::uvec2& cluster = _clusters[hit.x];
+                _indices[cluster.x + cluster.y] = hit.y;
+                ++cluster.y;
+            }
+
+            Header header = {
+                glm::uvec4(GRID_X, GRID_Y, GRID_Z, 0),
+                glm::vec4(_slice_scale, _slice_bias, _near, _far),
+                glm::vec4(screen_size.x, screen_size.y, 0.f, 0.f),
+                view
+            };
+            _grid.set_data(&header, sizeof(Header));
+            _grid.set_data(_clusters.data(), _clusters.size() * sizeof(glm::uvec2), sizeof(Header));
+
+            // Grow with some slack so moving lights don't reallocate every frame
+            const size_t indices_size = _indices.size() * sizeof(GLuint);
+            if (indices_size > _lightIndices.get_size()) {
+                _lightIndices.reserve(indices_size + indices_size / 2);
+            }
+            _lightIndices.set_data(_indices.data(), indices_size);
+        }
+
+        void bind() const {
+            _grid.bind();
+            _lightIndices.bind();
+        }
+
+        size_t get_assignment_count() const {
+            return _hits.size();
+        }
+    };
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Novo {
+    /// Block compressed formats, all of them encode 4x4 pixel blocks
+    enum class BlockFormat {
+        BC1, // RGB, 8 bytes per block
+        BC3, // RGBA, 16 bytes per block
+        BC5, // RG, e.g. normal maps, 16 bytes per block
+        BC7  // RGBA high quality, 16 bytes per block
+    };
+
+    constexpr size_t get_block_size(BlockFormat format) {
+        return format == BlockFormat::BC1 ? 8 : 16;
+    }
+
+    /// Block compressed image with its whole mip chain stored in one array
+    struct CompressedImage {
+        struct Level {
+            uint32_t width;
+            uint32_t height;
+            size_t offset; // Into data
+            size_t size;
+        };
+
+        BlockFormat format = BlockFormat::BC1;
+        std::vector<Level> levels;
+        std::vector<unsigned char> data;
+
+        static size_t get_level_size(BlockFormat format, uint32_t width, uint32_t height) {
+            return size_t((width + 3) / 4) * ((height + 3) / 4) * get_block_size(format);
+        }
+
+        /// Lays out `count` levels starting at `width` x `height` and allocates data for them
+        void allocate(BlockFormat block_format, uint32_t width, uint32_t height, size_t count) {
+            format = block_format;
+            levels.clear();
+            size_t offset = 0;
+            for (size_t i = 0; i < count; ++i) {
+                const size_t size = get_level_size(format, width, height);
+                levels.push_back({ width, height, offset, size });
+                offset += size;
+                width = width > 1 ? width / 2 : 1;
+                height = height > 1 ? height / 2 : 1;
+            }
+            data.assign(offset, 0);
+        }
+
+        uint32_t get_width() const {
+            return levels.empty() ? 0 : levels[0].width;
+        }
+
+        uint32_t get_height() const {
+            return levels.empty() ? 0 : levels[0].height;
+        }
+    };
+}
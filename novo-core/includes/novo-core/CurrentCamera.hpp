@@ -14,6 +14,10 @@ namespace Novo {
             return CurrentCamera::p_current_camera->get_view_proj_matrix();
         }
 
+        static std::shared_ptr<Camera> get_camera() {
+            return CurrentCamera::p_current_camera;
+        }
+
         static glm::vec3 get_position() {
             return CurrentCamera::p_current_camera->get_position();
         }
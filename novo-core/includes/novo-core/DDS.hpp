@@ -0,0 +1,200 @@
+#pragma once
+
+#include <novo-core/CompressedImage.hpp>
+
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace Novo {
+    /// Reading and writing of block compressed DirectDraw Surface files.
+    /// BC1, BC3 and BC5 are written with a FourCC header, BC7 needs the DX10 extension header
+    namespace DDS {
+        namespace detail {
+            constexpr uint32_t MAGIC = 0x20534444; // "DDS "
+
+            constexpr uint32_t FLAGS_REQUIRED = 0x1 | 0x2 | 0x4 | 0x1000; // Caps, height, width, pixel format
+            constexpr uint32_t FLAG_MIPMAP_COUNT = 0x20000;
+            constexpr uint32_t FLAG_LINEAR_SIZE = 0x80000;
+            constexpr uint32_t PIXEL_FLAG_FOURCC = 0x4;
+            constexpr uint32_t CAPS_TEXTURE = 0x1000;
+            constexpr uint32_t CAPS_MIPMAP = 0x400000 | 0x8; // Mipmap, complex
+
+            constexpr uint32_t DXGI_BC1_UNORM = 71, DXGI_BC1_SRGB = 72;
+            constexpr uint32_t DXGI_BC3_UNORM = 77, DXGI_BC3_SRGB = 78;
+            constexpr uint32_t DXGI_BC5_UNORM = 83;
+            constexpr uint32_t DXGI_BC7_UNORM = 98, DXGI_BC7_SRGB = 99;
+            constexpr uint32_t DIMENSION_TEXTURE2D = 3;
+
+            constexpr uint32_t MAX_DIMENSION = 16384; // Smallest GL_MAX_TEXTURE_SIZE GL 4.6 allows
+
+            /// Levels of a full mip chain down to 1x1, floor(log2(max(width, height))) + 1
+            inline size_t get_max_mip_count(uint32_t width, uint32_t height) {
+                size_t count = 1;
+                for (uint32_t size = width > height ? width : height; size > 1; size /= 2) {
+                    ++count;
+                }
+                return count;
+            }
+
+            constexpr uint32_t fourcc(const char (&code)[5]) {
+                return uint32_t(uint8_t(code[0])) | uint32_t(uint8_t(code[1])) << 8 | uint32_t(uint8_t(code[2])) << 16 | uint32_t(uint8_t(code[3])) << 24;
+            }
+
+            struct PixelFormat {
+                uint32_t size = 32;
+                uint32_t flags = 0;
+                uint32_t fourcc = 0;
+                uint32_t rgb_bit_count = 0;
+                uint32_t masks[4] = {};
+            };
+
+            struct Header {
+                uint32_t size = 124;
+                uint32_t flags = 0;
+                uint32_t height = 0;
+                uint32_t width = 0;
+                uint32_t linear_size = 0;
+                uint32_t depth = 0;
+                uint32_t mip_count = 0;
+                uint32_t reserved[11] = {};
+                PixelFormat pixel_format;
+                uint32_t caps[4] = {};
+                uint32_t reserved2 = 0;
+            };
+
+            struct HeaderDX10 {
+                uint32_t dxgi_format = 0;
+                uint32_t dimension = DIMENSION_TEXTURE2D;
+                uint32_t misc_flags = 0;
+                uint32_t array_size = 1;
+                uint32_t misc_flags2 = 0;
+            };
+
+            static_assert(sizeof(Header) == 124, "DDS header must be 124 bytes");
+            static_assert(sizeof(HeaderDX10) == 20, "DX10 header must be 20 bytes");
+        }
+
+        /// @return false if the file can't be read or isn't a supported block compressed 2D texture
+        inline bool read(const std::string& path, CompressedImage& image) {
+            using namespace detail;
+
+            std::ifstream file(path, std::ios::in | std::ios::binary);
+            if (!file.is_open()) {
+                std::cerr << "Failed to open file " << path << std::endl;
+                return false;
+            }
+
+            uint32_t magic = 0;
+            Header header;
+            file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+            file.read(reinterpret_cast<char*>(&header), sizeof(header));
+            if (!file || magic != MAGIC || header.size != sizeof(Header) || !(header.pixel_format.flags & PIXEL_FLAG_FOURCC)) {
+                std::cerr << "Not a block compressed DDS file: " << path << std::endl;
+                return false;
+            }
+
+            BlockFormat format;
+            const uint32_t code = header.pixel_format.fourcc;
+            if (code == fourcc("DXT1")) {
+                format = BlockFormat::BC1;
+            } else if (code == fourcc("DXT5")) {
+                format = BlockFormat::BC3;
+            } else if (code == fourcc("ATI2") || code == fourcc("BC5U")) {
+                format = BlockFormat::BC5;
+            } else if (code == fourcc("DX10")) {
+                HeaderDX10 dx10;
+                file.read(reinterpret_cast<char*>(&dx10), sizeof(dx10));
+                switch (dx10.dxgi_format) {
+                    case DXGI_BC1_UNORM: case DXGI_BC1_SRGB: format = BlockFormat::BC1; break;
+                    case DXGI_BC3_UNORM: case DXGI_BC3_SRGB: format = BlockFormat::BC3; break;
+                    case DXGI_BC5_UNORM: format = BlockFormat::BC5; break;
+                    case DXGI_BC7_UNORM: case DXGI_BC7_SRGB: format = BlockFormat::BC7; break;
+                    default:
+                        std::cerr << "Unsupported DXGI format " << dx10.dxgi_format << " in " << path << std::endl;
+                        return false;
+                }
+                if (!file || dx10.dimension != DIMENSION_TEXTURE2D || dx10.array_size > 1) {
+                    std::cerr << "Only single 2D textures are supported: " << path << std::endl;
+                    return false;
+                }
+            } else {
+                std::cerr << "Unsupported DDS format in " << path << std::endl;
+                return false;
+            }
+
+            // Everything below sizes an allocation, so a corrupt header must not get past here
+            if (header.width == 0 || header.height == 0 || header.width > MAX_DIMENSION || header.height > MAX_DIMENSION) {
+                std::cerr << "Invalid DDS size " << header.width << "x" << header.height << " in " << path << std::endl;
+                return false;
+            }
+            const size_t mip_count = (header.flags & FLAG_MIPMAP_COUNT) && header.mip_count > 0 ? header.mip_count : 1;
+            if (mip_count > get_max_mip_count(header.width, header.height)) {
+                std::cerr << "Invalid DDS mip count " << mip_count << " in " << path << std::endl;
+                return false;
+            }
+
+            size_t data_size = 0;
+            for (size_t i = 0, width = header.width, height = header.height; i < mip_count; ++i) {
+                data_size += CompressedImage::get_level_size(format, static_cast<uint32_t>(width), static_cast<uint32_t>(height));
+                width = width > 1 ? width / 2 : 1;
+                height = height > 1 ? height / 2 : 1;
+            }
+            const std::streamoff data_start = file.tellg();
+            file.seekg(0, std::ios::end);
+            const std::streamoff file_size = file.tellg();
+            file.seekg(data_start);
+            if (!file || file_size - data_start < static_cast<std::streamoff>(data_size)) {
+                std::cerr << "Truncated DDS file: " << path << std::endl;
+                return false;
+            }
+
+            image.allocate(format, header.width, header.height, mip_count);
+            file.read(reinterpret_cast<char*>(image.data.data()), image.data.size());
+            if (!file) {
+                std::cerr << "Truncated DDS file: " << path << std::endl;
+                return false;
+            }
+            return true;
+        }
+
+        inline bool write(const std::string& path, const CompressedImage& image) {
+            using namespace detail;
+
+            Header header;
+            header.flags = FLAGS_REQUIRED | FLAG_MIPMAP_COUNT | FLAG_LINEAR_SIZE;
+            header.width = image.get_width();
+            header.height = image.get_height();
+            header.linear_size = image.levels.empty() ? 0 : static_cast<uint32_t>(image.levels[0].size);
+            header.mip_count = static_cast<uint32_t>(image.levels.size());
+            header.pixel_format.flags = PIXEL_FLAG_FOURCC;
+            header.caps[0] = CAPS_TEXTURE | (image.levels.size() > 1 ? CAPS_MIPMAP : 0);
+
+            HeaderDX10 dx10;
+            switch (image.format) {
+                case BlockFormat::BC1: header.pixel_format.fourcc = fourcc("DXT1"); break;
+                case BlockFormat::BC3: header.pixel_format.fourcc = fourcc("DXT5"); break;
+                case BlockFormat::BC5: header.pixel_format.fourcc = fourcc("ATI2"); break;
+                case BlockFormat::BC7:
+                    header.pixel_format.fourcc = fourcc("DX10");
+                    dx10.dxgi_format = DXGI_BC7_UNORM;
+                    break;
+            }
+
+            std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) {
+                std::cerr << "Failed to open file " << path << std::endl;
+                return false;
+            }
+
+            const uint32_t magic = MAGIC;
+            file.write(reinterpret_cast<const char*>(&magic), sizeof(magic));
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            if (image.format == BlockFormat::BC7) {
+                file.write(reinterpret_cast<const char*>(&dx10), sizeof(dx10));
+            }
+            file.write(reinterpret_cast<const char*>(image.data.data()), image.data.size());
+            return static_cast<bool>(file);
+        }
+    }
+}
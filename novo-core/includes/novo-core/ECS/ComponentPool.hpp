@@ -0,0 +1,105 @@
+#pragma once
+
+#include <novo-core/ECS/Entity.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace Novo {
+    namespace ECS {
+        /// Type-erased part of a pool, lets the registry remove an entity from every pool it is in
+        class PoolBase {
+        protected:
+            static constexpr uint32_t NONE = UINT32_MAX;
+
+            std::vector<uint32_t> _sparse; // Entity index -> dense index
+            std::vector<Entity> _entities; // Dense, parallel to the components
+        public:
+            virtual ~PoolBase() = default;
+
+            virtual void remove(Entity entity) = 0;
+            virtual void clear() = 0;
+
+            bool contains(Entity entity) const {
+                return entity.index < _sparse.size() && _sparse[entity.index] != NONE && _entities[_sparse[entity.index]] == entity;
+            }
+
+            const std::vector<Entity>& get_entities() const {
+                return _entities;
+            }
+
+            size_t size() const {
+                return _entities.size();
+            }
+        };
+
+        /// Sparse set: components of one type packed in a dense array, removal moves the last component into the hole
+        template <typename T>
+        class ComponentPool : public PoolBase {
+        private:
+            std::vector<T> _components;
+        public:
+            template <typename... Args>
+            T& emplace(Entity entity, Args&&... args) {
+                if (contains(entity)) {
+                    T& component = _components[_sparse[entity.index]];
+                    component = T{ std::forward<Args>(args)... };
+                    return component;
+                }
+
+                if (entity.index >= _sparse.size()) {
+                    _sparse.resize(entity.index + 1, NONE);
+                }
+                _sparse[entity.index] = static_cast<uint32_t>(_entities.size());
+                _entities.push_back(entity);
+                _components.push_back(T{ std::forward<Args>(args)... });
+                return _components.back();
+            }
+
+            virtual void remove(Entity entity) override {
+                if (!contains(entity)) return;
+
+                const uint32_t index = _sparse[entity.index];
+                const uint32_t last = static_cast<uint32_t>(_entities.size() - 1);
+                if (index != last) {
+                    _entities[index] = _entities[last];
+                    _components[index] = std::move(_components[last]);
+                    _sparse[_entities[index].index] = index;
+                }
+                _entities.pop_back();
+                _components.pop_back();
+                _sparse[entity.index] = NONE;
+            }
+
+            virtual void clear() override {
+                _sparse.clear();
+                _entities.clear();
+                _components.clear();
+            }
+
+            /// @warning The entity must have the component
+            T& get(Entity entity) {
+                return _components[_sparse[entity.index]];
+            }
+
+            const T& get(Entity entity) const {
+                return _components[_sparse[entity.index]];
+            }
+
+            T* try_get(Entity entity) {
+                return contains(entity) ? &_components[_sparse[entity.index]] : nullptr;
+            }
+
+            /// Dense component array, indexed like get_entities()
+            std::vector<T>& get_components() {
+                return _components;
+            }
+
+            const std::vector<T>& get_components() const {
+                return _components;
+            }
+        };
+    }
+}
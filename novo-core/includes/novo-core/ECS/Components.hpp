@@ -0,0 +1,46 @@
+#pragma once
+
+#include <novo-core/AABB.hpp>
+#include <novo-core/BVH.hpp>
+#include <novo-core/Mesh/MeshBase.hpp>
+#include <novo-core/Mesh/LightSource.hpp>
+
+#include <memory>
+#include <string>
+
+namespace Novo {
+    namespace ECS {
+        /// World placement. `world`, `normal` and `world_bounds` are derived, the transform system rebuilds them when `dirty` is set
+        struct Transform {
+            glm::vec3 position = glm::vec3(0.f);
+            glm::vec3 rotation = glm::vec3(0.f); // Degrees
+            glm::vec3 scale = glm::vec3(1.f);
+            AABB local_bounds = { glm::vec3(-1.f), glm::vec3(1.f) };
+
+            glm::mat4 world = glm::mat4(1.f);
+            glm::mat3 normal = glm::mat3(1.f);
+            AABB world_bounds;
+            bool dirty = true;
+        };
+
+        /// Drawable part of an entity. The mesh keeps geometry, shader, texture, material and the editor UI
+        struct MeshRenderer {
+            std::shared_ptr<Mesh::MeshBase> mesh;
+            int32_t bvh_node = BVH::NULL_NODE;
+        };
+
+        struct Light {
+            std::shared_ptr<Mesh::LightSource> source;
+            glm::vec3 color = glm::vec3(1.f);
+            float radius = 10.f;
+            bool active = true;
+        };
+
+        struct Name {
+            std::string value;
+        };
+
+        /// Tag, the entity is skipped by culling and picking. A hidden light still lights the scene, only its gizmo is hidden
+        struct Hidden {};
+    }
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Novo {
+    namespace ECS {
+        /// Index into the registry's entity table plus the generation it was created with.
+        /// A destroyed entity's slot is reused with a new generation, so old handles stay invalid
+        struct Entity {
+            static constexpr uint32_t INVALID = UINT32_MAX;
+
+            uint32_t index = INVALID;
+            uint32_t generation = 0;
+
+            bool is_valid() const { return index != INVALID; }
+
+            bool operator==(const Entity& other) const {
+                return index == other.index && generation == other.generation;
+            }
+
+            bool operator!=(const Entity& other) const {
+                return !(*this == other);
+            }
+        };
+    }
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <novo-core/ECS/Entity.hpp>
+#include <novo-core/ECS/ComponentPool.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+namespace Novo {
+    namespace ECS {
+        inline size_t next_component_id() {
+            static size_t counter = 0;
+            return counter++;
+        }
+
+        /// Index of the component type in Registry's pool table, assigned on first use
+        template <typename T>
+        size_t component_id() {
+            static const size_t id = next_component_id();
+            return id;
+        }
+
+        /// Owns the entities and one ComponentPool per component type
+        class Registry {
+        private:
+            std::vector<uint32_t> _generations;
+            std::vector<uint32_t> _free;
+            size_t _alive = 0;
+
+            std::vector<std::unique_ptr<PoolBase>> _pools; // Indexed by component_id<T>()
+
+            template <typename T>
+            const ComponentPool<T>* find_pool() const {
+                const size_t id = component_id<T>();
+                return id < _pools.size() ? static_cast<const ComponentPool<T>*>(_pools[id].get()) : nullptr;
+            }
+        public:
+            Entity create() {
+                uint32_t index;
+                if (_free.empty()) {
+                    index = static_cast<uint32_t>(_generations.size());
+                    _generations.push_back(0);
+                } else {
+                    index = _free.back();
+                    _free.pop_back();
+                }
+                ++_alive;
+                return { index, _generations[index] };
+            }
+
+            /// Removes the entity from every pool. Its index is reused with the next generation
+            void destroy(Entity entity) {
+                if (!is_alive(entity)) return;
+
+                for (auto& pool : _pools) {
+                    if (pool) pool->remove(entity);
+                }
+                ++_generations[entity.index];
+                _free.push_back(entity.index);
+                --_alive;
+            }
+
+            bool is_alive(Entity entity) const {
+                return entity.index < _generations.size() && _generations[entity.index] == entity.generation;
+            }
+
+            /// Current entity of a bare index, for code that stores indices only (e.g. BVH user data)
+            Entity get_entity(uint32_t index) const {
+                return { index, _generations[index] };
+            }
+
+            /// Upper bound for Entity::index
+            size_t get_capacity() const {
+                return _generations.size();
+            }
+
+            size_t size() const {
+                return _alive;
+            }
+
+            /// Destroys every entity. Indices are kept and move to the next generation like in destroy(), so handles from
+            /// before the clear stay dead instead of matching new entities
+            void clear() {
+                for (auto& pool : _pools) {
+                    if (pool) pool->clear();
+                }
+                _free.clear();
+                for (size_t index = _generations.size(); index-- > 0;) {
+                    ++_generations[index];
+                    _free.push_back(static_cast<uint32_t>(index));
+                }
+                _alive = 0;
+            }
+
+            template <typename T>
+            ComponentPool<T>& pool() {
+                const size_t id = component_id<T>();
+                if (id >= _pools.size()) {
+                    _pools.resize(id + 1);
+                }
+                if (!_pools[id]) {
+                    _pools[id] = std::make_unique<ComponentPool<T>>();
+                }
+                return *static_cast<ComponentPool<T>*>(_pools[id].get());
+            }
+
+            template <typename T, typename... Args>
+            T& emplace(Entity entity, Args&&... args) {
+                return pool<T>().emplace(entity, std::forward<Args>(args)...);
+            }
+
+            template <typename T>
+            void remove(Entity entity) {
+                pool<T>().remove(entity);
+            }
+
+            template <typename T>
+            bool has(Entity entity) const {
+                const ComponentPool<T>* found = find_pool<T>();
+                return found && found->contains(entity);
+            }
+
+            /// @warning The entity must have the component
+            template <typename T>
+            T& get(Entity entity) {
+                return pool<T>().get(entity);
+            }
+
+            template <typename T>
+            T* try_get(Entity entity) {
+                return pool<T>().try_get(entity);
+            }
+
+            /// Calls `callback(entity, T&, Rest&...)` for every entity having all listed components.
+            /// Iterates the smallest of the pools. Components of other types may be added or removed from the callback,
+            /// the iterated types may not
+            template <typename T, typename... Rest, typename Callback>
+            void each(Callback&& callback) {
+                ComponentPool<T>& first = pool<T>();
+
+                if constexpr (sizeof...(Rest) == 0) {
+                    const std::vector<Entity>& entities = first.get_entities();
+                    std::vector<T>& components = first.get_components();
+                    for (size_t i = 0; i < entities.size(); ++i) {
+                        callback(entities[i], components[i]);
+                    }
+                } else {
+                    const PoolBase* driver = &first;
+                    for (const PoolBase* other : { static_cast<const PoolBase*>(&pool<Rest>())... }) {
+                        if (other->size() < driver->size()) driver = other;
+                    }
+
+                    std::tuple<ComponentPool<Rest>&...> rest(pool<Rest>()...);
+                    const std::vector<Entity>& entities = driver->get_entities();
+                    for (size_t i = 0; i < entities.size(); ++i) {
+                        const Entity entity = entities[i];
+                        if (!first.contains(entity) || !(std::get<ComponentPool<Rest>&>(rest).contains(entity) && ...)) continue;
+                        callback(entity, first.get(entity), std::get<ComponentPool<Rest>&>(rest).get(entity)...);
+                    }
+                }
+            }
+        };
+    }
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <novo-core/ECS/Registry.hpp>
+#include <novo-core/ECS/Components.hpp>
+#include <novo-core/BVH.hpp>
+#include <novo-core/Frustum.hpp>
+#include <novo-core/LightBuffer.hpp>
+#include <novo-core/JobSystem.hpp>
+
+#include <vector>
+
+namespace Novo {
+    namespace ECS {
+        inline void set_hidden(Registry& registry, Entity entity, bool hidden) {
+            if (hidden) {
+                registry.emplace<Hidden>(entity);
+            } else {
+                registry.remove<Hidden>(entity);
+            }
+        }
+
+        /// Copies the state of edited meshes and lights into their entities. Meshes report themselves through their change list
+        /// (MeshBase::set_change_list()), so only the reported entities are read
+        /// @param changed entity indices reported since the last call, emptied
+        /// @param synced receives the entities whose components were updated
+        inline void sync_changes(Registry& registry, std::vector<uint32_t>& changed, std::vector<Entity>& synced) {
+            for (const uint32_t index : changed) {
+                const Entity entity = registry.get_entity(index);
+                Mesh::MeshBase* mesh = nullptr;
+                if (MeshRenderer* renderer = registry.try_get<MeshRenderer>(entity)) {
+                    mesh = renderer->mesh.get();
+                } else if (Light* light = registry.try_get<Light>(entity)) {
+                    Mesh::LightSource& source = *light->source;
+                    light->color = source.get_light_color();
+                    light->radius = source.get_radius();
+                    light->active = source.is_active();
+                    mesh = &source;
+                }
+                if (!mesh) continue; // Destroyed after it was reported
+
+                mesh->take_change();
+                Transform& transform = registry.get<Transform>(entity);
+                transform.position = mesh->get_position();
+                transform.rotation = mesh->get_rotation();
+                transform.scale = mesh->get_size();
+                transform.local_bounds = mesh->get_local_bounds();
+                transform.dirty = true;
+
+                set_hidden(registry, entity, !mesh->is_visible());
+                synced.push_back(entity);
+            }
+            changed.clear();
+        }
+
+        /// Items per job for the parallel systems, large enough that scheduling stays a small part of the work
+        constexpr size_t TRANSFORM_GRAIN = 2048;
+        constexpr size_t CULL_SUBTREES_PER_THREAD = 4;
+
+        /// Rebuilds world matrices and bounds of dirty transforms, split over `jobs` if given
+        /// @param moved receives the entities whose transform changed, in pool order
+        inline void update_transforms(Registry& registry, std::vector<Entity>& moved, JobSystem* jobs = nullptr) {
+            ComponentPool<Transform>& pool = registry.pool<Transform>();
+            const std::vector<Entity>& entities = pool.get_entities();
+            std::vector<Transform>& transforms = pool.get_components();
+
+            auto update = [&](size_t begin, size_t end, std::vector<Entity>& out) {
+                for (size_t i = begin; i < end; ++i) {
+                    Transform& transform = transforms[i];
+                    if (!transform.dirty) continue;
+
+                    Mesh::MeshBase::compose(transform.position, transform.rotation, transform.scale, transform.world, transform.normal);
+                    transform.world_bounds = transform.local_bounds.transform(transform.world);
+                    transform.dirty = false;
+                    out.push_back(entities[i]);
+                }
+            };
+
+            if (!jobs || transforms.size() <= TRANSFORM_GRAIN) {
+                update(0, transforms.size(), moved);
+                return;
+            }
+
+            // Every chunk writes its own list, merged afterwards so the output doesn't depend on scheduling
+            std::vector<std::vector<Entity>> chunk_moved((transforms.size() + TRANSFORM_GRAIN - 1) / TRANSFORM_GRAIN);
+            jobs->parallel_for(transforms.size(), TRANSFORM_GRAIN, [&](size_t begin, size_t end) {
+                update(begin, end, chunk_moved[begin / TRANSFORM_GRAIN]);
+            });
+            for (auto& chunk : chunk_moved) {
+                moved.insert(moved.end(), chunk.begin(), chunk.end());
+            }
+        }
+
+        /// Inserts or moves the BVH leaves of moved renderable entities
+        inline void update_bvh(Registry& registry, BVH& bvh, const std::vector<Entity>& moved) {
+            ComponentPool<MeshRenderer>& renderers = registry.pool<MeshRenderer>();
+            ComponentPool<Transform>& transforms = registry.pool<Transform>();
+
+            for (const Entity entity : moved) {
+                MeshRenderer* renderer = renderers.try_get(entity);
+                if (!renderer) continue;
+
+                const AABB& bounds = transforms.get(entity).world_bounds;
+                if (renderer->bvh_node == BVH::NULL_NODE) {
+                    renderer->bvh_node = bvh.create_proxy(bounds, entity.index);
+                } else {
+                    bvh.move_proxy(renderer->bvh_node, bounds);
+                }
+            }
+        }
+
+        /// Queries the BVH, split into subtrees over `jobs` if given
+        /// @param visible receives the renderable entities intersecting the frustum, hidden ones are skipped
+        inline void cull(Registry& registry, const BVH& bvh, const Frustum& frustum, std::vector<Entity>& visible, JobSystem* jobs = nullptr) {
+            const ComponentPool<Hidden>& hidden = registry.pool<Hidden>();
+            const Registry& entities = registry;
+
+            visible.clear();
+            if (!jobs) {
+                bvh.query(frustum, [&](uint32_t index) {
+                    const Entity entity = entities.get_entity(index);
+                    if (!hidden.contains(entity)) visible.push_back(entity);
+                });
+                return;
+            }
+
+            std::vector<int32_t> roots;
+            bvh.split((jobs->get_thread_count() + 1) * CULL_SUBTREES_PER_THREAD, roots);
+
+            std::vector<std::vector<Entity>> subtree_visible(roots.size());
+            jobs->parallel_for(roots.size(), 1, [&](size_t begin, size_t end) {
+                BVH::FrustumScratch scratch;
+                for (size_t i = begin; i < end; ++i) {
+                    std::vector<Entity>& out = subtree_visible[i];
+                    bvh.query(roots[i], frustum, scratch, [&](uint32_t index) {
+                        const Entity entity = entities.get_entity(index);
+                        if (!hidden.contains(entity)) out.push_back(entity);
+                    });
+                }
+            });
+            for (auto& subtree : subtree_visible) {
+                visible.insert(visible.end(), subtree.begin(), subtree.end());
+            }
+        }
+
+        /// Packs every active light into `buffer`. Hidden only hides a light's gizmo, it still lights the scene
+        inline void gather_lights(Registry& registry, LightBuffer& buffer) {
+            buffer.clear();
+            registry.each<Light, Transform>([&](Entity, Light& light, Transform& transform) {
+                if (!light.active) return;
+                buffer.add_light(transform.position, light.color, light.radius);
+            });
+        }
+    }
+}
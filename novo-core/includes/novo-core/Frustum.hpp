@@ -0,0 +1,108 @@
+#pragma once
+
+#include <novo-core/AABB.hpp>
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace Novo {
+    /// Box bounds stored as separate center/extent arrays so a whole range can be tested with vector instructions
+    class BoundsList {
+    private:
+        std::vector<float> _cx, _cy, _cz;
+        std::vector<float> _ex, _ey, _ez;
+    public:
+        void push(const AABB& box) {
+            const glm::vec3 center = box.get_center();
+            const glm::vec3 extents = box.get_extents();
+            _cx.push_back(center.x); _cy.push_back(center.y); _cz.push_back(center.z);
+            _ex.push_back(extents.x); _ey.push_back(extents.y); _ez.push_back(extents.z);
+        }
+
+        /// Drops the boxes from `count` on
+        void truncate(size_t count) {
+            _cx.resize(count); _cy.resize(count); _cz.resize(count);
+            _ex.resize(count); _ey.resize(count); _ez.resize(count);
+        }
+
+        size_t size() const {
+            return _cx.size();
+        }
+
+        friend class Frustum;
+    };
+
+    class Frustum {
+    private:
+        std::array<glm::vec4, 6> _planes; // XYZ - normal pointing inside, W - distance
+    public:
+        /// Extracts the clip planes of a view projection matrix (Gribb-Hartmann)
+        explicit Frustum(const glm::mat4& view_proj) {
+            const glm::vec4 row_x = glm::vec4(view_proj[0][0], view_proj[1][0], view_proj[2][0], view_proj[3][0]);
+            const glm::vec4 row_y = glm::vec4(view_proj[0][1], view_proj[1][1], view_proj[2][1], view_proj[3][1]);
+            const glm::vec4 row_z = glm::vec4(view_proj[0][2], view_proj[1][2], view_proj[2][2], view_proj[3][2]);
+            const glm::vec4 row_w = glm::vec4(view_proj[0][3], view_proj[1][3], view_proj[2][3], view_proj[3][3]);
+
+            _planes = {
+                row_w + row_x, // Left
+                row_w - row_x, // Right
+                row_w + row_y, // Bottom
+                row_w - row_y, // Top
+                row_w + row_z, // Near
+                row_w - row_z, // Far
+            };
+
+            for (auto& plane : _planes) {
+                plane = plane / glm::length(glm::vec3(plane));
+            }
+        }
+
+        const std::array<glm::vec4, 6>& get_planes() const {
+            return _planes;
+        }
+
+        enum class Test { Outside, Intersects, Inside };
+
+        /// Reports boxes that lie completely inside separately, so hierarchies can skip testing their children
+        Test classify(const AABB& box) const {
+            const glm::vec3 center = box.get_center();
+            const glm::vec3 extents = box.get_extents();
+            Test result = Test::Inside;
+            for (const glm::vec4& plane : _planes) {
+                const glm::vec3 normal = glm::vec3(plane);
+                const float distance = glm::dot(normal, center) + plane.w;
+                const float radius = glm::dot(glm::abs(normal), extents);
+                if (distance + radius < 0.f) return Test::Outside;
+                if (distance - radius < 0.f) result = Test::Intersects;
+            }
+            return result;
+        }
+
+        /// Writes 1 to `visible[i]` if box `first + i` of `bounds` intersects the frustum, 0 otherwise, for `count` boxes.
+        /// Plane-major and branch-free over the SoA arrays, so the compiler tests several boxes per instruction
+        void cull(const BoundsList& bounds, size_t first, size_t count, uint8_t* visible) const {
+            const float* cx = bounds._cx.data() + first;
+            const float* cy = bounds._cy.data() + first;
+            const float* cz = bounds._cz.data() + first;
+            const float* ex = bounds._ex.data() + first;
+            const float* ey = bounds._ey.data() + first;
+            const float* ez = bounds._ez.data() + first;
+
+            for (size_t i = 0; i < count; ++i) {
+                visible[i] = 1;
+            }
+
+            for (const glm::vec4& plane : _planes) {
+                const float nx = plane.x, ny = plane.y, nz = plane.z, w = plane.w;
+                const float ax = glm::abs(nx), ay = glm::abs(ny), az = glm::abs(nz);
+                for (size_t i = 0; i < count; ++i) {
+                    const float distance = nx * cx[i] + ny * cy[i] + nz * cz[i] + w;
+                    const float radius = ax * ex[i] + ay * ey[i] + az * ez[i];
+                    visible[i] &= static_cast<uint8_t>(distance + radius >= 0.f);
+                }
+            }
+        }
+    };
+}
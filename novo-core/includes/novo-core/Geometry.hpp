@@ -0,0 +1,67 @@
+#pragma once
+
+#include <novo-core/GeometryArena.hpp>
+
+#include <array>
+#include <memory>
+
+namespace Novo {
+    /// Vertex and index range of one mesh shape inside the arena of its vertex layout
+    class Geometry {
+    private:
+        std::shared_ptr<GeometryArena> _arena;
+        GeometryArena::Range _range;
+    public:
+        Geometry(const void* vertices, const size_t size, const BufferLayout& layout, const GLuint* indices, const size_t count)
+            : _arena(GeometryArena::get(layout)),
+              _range(_arena->allocate(vertices, size / layout.get_stride(), indices, count)) {}
+
+        ~Geometry() {
+            _arena->release(_range);
+        }
+
+        Geometry(const Geometry&) = delete;
+        Geometry& operator=(const Geometry&) = delete;
+
+        void draw(GLenum method = GL_TRIANGLES) {
+            _arena->get_vao().bind();
+            glDrawElementsBaseVertex(method, static_cast<GLsizei>(_range.count), GL_UNSIGNED_INT, _range.get_index_offset(), _range.base_vertex);
+        }
+
+        GeometryArena& get_arena() { return *_arena; }
+        const GeometryArena::Range& get_range() const { return _range; }
+    };
+
+    enum class GeometryID {
+        Box = 0,
+        BoxInverted,
+        Plane,
+        PlaneOneSided,
+        Count,
+    };
+
+    /// Shares built-in geometry between every mesh that uses it.
+    /// Buffers are created on first request and freed when the last mesh holding them is destroyed.
+    class GeometryRegistry {
+    private:
+        using Cache = std::array<std::weak_ptr<Geometry>, static_cast<size_t>(GeometryID::Count)>;
+
+        static Cache& cache() {
+            static Cache s_cache;
+            return s_cache;
+        }
+    public:
+        /// Returns the shared geometry `id`, calling `create` to build it if no mesh holds it yet
+        template<typename Factory>
+        static std::shared_ptr<Geometry> get(const GeometryID id, Factory&& create) {
+            std::weak_ptr<Geometry>& slot = cache()[static_cast<size_t>(id)];
+            if (auto geometry = slot.lock()) {
+                return geometry;
+            }
+
+            std::shared_ptr<Geometry> geometry = create();
+            slot = geometry;
+            return geometry;
+        }
+    };
+}
@@ -0,0 +1,213 @@
+#pragma once
+
+#include <novo-core/VBO.hpp>
+#include <novo-core/IBO.hpp>
+#include <novo-core/VAO.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace Novo {
+    /// First fit allocator of [offset, offset + size) ranges. Neighbouring free ranges are merged when released
+    class RangeAllocator {
+    private:
+        std::map<size_t, size_t> _free; // offset -> size
+        size_t _capacity = 0;
+    public:
+        static constexpr size_t INVALID = SIZE_MAX;
+
+        /// Adds [old capacity, `capacity`) to the free space
+        void grow(size_t capacity) {
+            if (capacity <= _capacity) return;
+            const size_t offset = _capacity;
+            _capacity = capacity;
+            release(offset, capacity - offset);
+        }
+
+        /// @return offset of the range or INVALID if no free range is large enough
+        size_t allocate(size_t size) {
+            for (auto it = _free.begin(); it != _free.end(); ++it) {
+                if (it->second < size) continue;
+
+                const size_t offset = it->first;
+                const size_t rest = it->second - size;
+                auto hint = _free.erase(it);
+                if (rest > 0) _free.emplace_hint(hint, offset + size, rest);
+                return offset;
+            }
+            return INVALID;
+        }
+
+        void release(size_t offset, size_t size) {
+            if (size == 0) return;
+
+            auto next = _free.lower_bound(offset);
+            if (next != _free.end() && offset + size == next->first) {
+                size += next->second;
+                next = _free.erase(next);
+            }
+            if (next != _free.begin()) {
+                auto previous = std::prev(next);
+                if (previous->first + previous->second == offset) {
+                    previous->second += size;
+                    return;
+                }
+            }
+            _free.emplace_hint(next, offset, size);
+        }
+
+        size_t get_capacity() const {
+            return _capacity;
+        }
+    };
+
+    /// One vertex buffer and one index buffer shared by all geometry of a vertex layout. Geometry gets sub-ranges and is
+    /// drawn with a base vertex, so any mesh can be drawn without switching buffers. The arena also owns the vertex
+    /// formats over its buffers, one per instance layout, shared by everything drawing its geometry
+    class GeometryArena {
+    public:
+        struct Range {
+            GLint base_vertex = 0;
+            GLuint vertex_count = 0;
+            GLuint first_index = 0;
+            GLuint count = 0; // Indices
+
+            /// Byte offset of the first index, as glDrawElements* expects it
+            const void* get_index_offset() const {
+                return reinterpret_cast<const void*>(static_cast<uintptr_t>(first_index) * sizeof(GLuint));
+            }
+        };
+
+        static constexpr size_t INITIAL_VERTICES = 1 << 16;
+        static constexpr size_t INITIAL_INDICES = 1 << 18;
+    private:
+        BufferLayout _layout;
+        std::unique_ptr<VBO> _vbo = nullptr;
+        std::unique_ptr<IBO> _ibo = nullptr;
+        std::unique_ptr<VAO> _vao = nullptr;
+        std::vector<std::pair<BufferLayout, std::unique_ptr<VAO>>> _instanced_vaos; // Instance layout at binding 1
+        RangeAllocator _vertices;
+        RangeAllocator _indices;
+
+        /// Points every VAO at the current buffers after they were replaced
+        void attach_buffers() {
+            _vao->setVertexBuffer(0, *_vbo);
+            _vao->setIBO(*_ibo);
+            for (auto& instanced : _instanced_vaos) {
+                instanced.second->setVertexBuffer(0, *_vbo);
+                instanced.second->setIBO(*_ibo);
+            }
+        }
+
+        /// Moves the vertices into a buffer of `capacity` vertices
+        void grow_vertices(size_t capacity) {
+            auto vbo = std::make_unique<VBO>(nullptr, capacity * _layout.get_stride(), _layout);
+            if (_vbo) glCopyNamedBufferSubData(_vbo->getID(), vbo->getID(), 0, 0, _vbo->get_size());
+            _vbo = std::move(vbo);
+            _vertices.grow(capacity);
+        }
+
+        /// Moves the indices into a buffer of `capacity` indices
+        void grow_indices(size_t capacity) {
+            auto ibo = std::make_unique<IBO>(nullptr, capacity);
+            if (_ibo) glCopyNamedBufferSubData(_ibo->getID(), ibo->getID(), 0, 0, _ibo->get_count() * sizeof(GLuint));
+            _ibo = std::move(ibo);
+            _indices.grow(capacity);
+        }
+
+        /// Capacity to grow to when `size` more elements don't fit
+        static size_t next_capacity(const RangeAllocator& allocator, size_t size) {
+            return std::max(allocator.get_capacity() * 2, allocator.get_capacity() + size);
+        }
+    public:
+        explicit GeometryArena(const BufferLayout& layout) : _layout(layout) {
+            grow_vertices(INITIAL_VERTICES);
+            grow_indices(INITIAL_INDICES);
+            _vao = std::make_unique<VAO>();
+            _vao->addVBO(*_vbo);
+            _vao->setIBO(*_ibo);
+        }
+
+        GeometryArena(const GeometryArena&) = delete;
+        GeometryArena& operator=(const GeometryArena&) = delete;
+
+        /// Arena of `layout`, created on first request and freed when the last geometry using it is destroyed
+        static std::shared_ptr<GeometryArena> get(const BufferLayout& layout) {
+            static std::vector<std::weak_ptr<GeometryArena>> s_arenas;
+            for (auto it = s_arenas.begin(); it != s_arenas.end();) {
+                std::shared_ptr<GeometryArena> arena = it->lock();
+                if (!arena) {
+                    it = s_arenas.erase(it);
+                    continue;
+                }
+                if (arena->_layout == layout) return arena;
+                ++it;
+            }
+
+            auto arena = std::make_shared<GeometryArena>(layout);
+            s_arenas.push_back(arena);
+            return arena;
+        }
+
+        /// Copies `vertex_count` vertices and `count` indices into the arena. Indices stay relative to the first vertex
+        Range allocate(const void* vertices, size_t vertex_count, const GLuint* indices, size_t count) {
+            bool grown = false;
+            size_t base_vertex = _vertices.allocate(vertex_count);
+            while (base_vertex == RangeAllocator::INVALID) {
+                grow_vertices(next_capacity(_vertices, vertex_count));
+                base_vertex = _vertices.allocate(vertex_count);
+                grown = true;
+            }
+            size_t first_index = _indices.allocate(count);
+            while (first_index == RangeAllocator::INVALID) {
+                grow_indices(next_capacity(_indices, count));
+                first_index = _indices.allocate(count);
+                grown = true;
+            }
+            if (grown) attach_buffers();
+
+            _vbo->update(base_vertex * _layout.get_stride(), vertices, vertex_count * _layout.get_stride());
+            _ibo->update(first_index, indices, count);
+
+            Range range;
+            range.base_vertex = static_cast<GLint>(base_vertex);
+            range.vertex_count = static_cast<GLuint>(vertex_count);
+            range.first_index = static_cast<GLuint>(first_index);
+            range.count = static_cast<GLuint>(count);
+            return range;
+        }
+
+        void release(const Range& range) {
+            _vertices.release(static_cast<size_t>(range.base_vertex), range.vertex_count);
+            _indices.release(range.first_index, range.count);
+        }
+
+        VBO& get_vbo() { return *_vbo; }
+        IBO& get_ibo() { return *_ibo; }
+
+        /// Vertex attributes of the layout only, for draws without instance data
+        VAO& get_vao() { return *_vao; }
+
+        /// Vertex attributes of the layout plus `instance_layout` at binding 1. Callers attach their instance buffer with
+        /// setVertexBuffer(1, ...), so switching between batches rebinds one buffer instead of switching VAOs
+        VAO& get_vao(const BufferLayout& instance_layout) {
+            for (auto& instanced : _instanced_vaos) {
+                if (instanced.first == instance_layout) return *instanced.second;
+            }
+            auto vao = std::make_unique<VAO>();
+            vao->addVBO(*_vbo);
+            vao->addLayout(instance_layout);
+            vao->setIBO(*_ibo);
+            _instanced_vaos.emplace_back(instance_layout, std::move(vao));
+            return *_instanced_vaos.back().second;
+        }
+
+        const BufferLayout& get_layout() const {
+            return _layout;
+        }
+    };
+}
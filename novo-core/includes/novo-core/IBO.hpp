@@ -10,15 +10,18 @@ namespace Novo {
     public:
         IBO(const void* data, const size_t count, const VBO::Mode mode = VBO::Mode::STATIC)
             : _count(count) {
-            glGenBuffers(1, &_id);
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _id);
-            glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(GLuint), data, VBO::modeToGL(mode));
+            glCreateBuffers(1, &_id);
+            glNamedBufferData(_id, count * sizeof(GLuint), data, VBO::modeToGL(mode));
         }
 
         ~IBO() {
             glDeleteBuffers(1, &_id);
         }
 
+        GLuint getID() const {
+            return _id;
+        }
+
         void bind() const {
             glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _id);
         }
@@ -27,6 +30,11 @@ namespace Novo {
             glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
         }
 
+        /// Overwrites `count` indices starting at index `offset` without reallocating the buffer
+        void update(const size_t offset, const GLuint* indices, const size_t count) {
+            glNamedBufferSubData(_id, offset * sizeof(GLuint), count * sizeof(GLuint), indices);
+        }
+
         size_t get_count() const {
             return _count;
         }
@@ -0,0 +1,251 @@
+#pragma once
+
+#include <novo-core/InstanceBatch.hpp>
+#include <novo-core/SSBO.hpp>
+#include <novo-core/StagingRing.hpp>
+#include <novo-core/StateCache.hpp>
+
+#include <novo-precompiles/Layouts.h>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace Novo {
+    /// Submits the visible batches with glMultiDrawElementsIndirect. Every batch is one indirect command, consecutive
+    /// batches sharing program, texture, cull state and geometry arena go out in a single call. Instances of all batches live
+    /// in one buffer and are found through the command's base instance, material factors are fetched by gl_DrawID
+    class IndirectRenderer {
+    public:
+        /// Layout fixed by GL for GL_DRAW_INDIRECT_BUFFER
+        struct Command {
+            GLuint count;
+            GLuint instance_count;
+            GLuint first_index;
+            GLint base_vertex;
+            GLuint base_instance;
+        };
+
+        /// Per-command material, matches `DrawData` in object.frag
+        struct DrawData {
+            float ambient_factor;
+            float diffuse_factor;
+            float specular_factor;
+            float shininess;
+        };
+
+        static constexpr GLuint DRAW_DATA_BINDING = 3;
+    private:
+        /// Commands drawn by one glMultiDrawElementsIndirect call
+        struct Run {
+            InstanceBatch* batch; // First batch, its state applies to the whole run
+            size_t first;
+            size_t count;
+        };
+
+        struct Uniforms {
+            UniformHandle instanced;
+            UniformHandle indirect;
+            UniformHandle draw_base;
+            UniformHandle view_projection;
+            UniformHandle camera_position;
+        };
+
+        std::vector<InstanceBatch*> _batches;
+        std::vector<InstanceBatch*> _last_batches;
+        std::vector<Command> _commands;
+        std::vector<Command> _last_commands;
+        std::vector<DrawData> _draw_data;
+        std::vector<DrawData> _last_draw_data;
+        std::vector<Run> _runs;
+        std::vector<InstanceBatch::InstanceData> _instances; // Packing space when there is no staging ring
+        size_t _instance_count = 0;
+        bool _dirty = true;
+
+        std::unique_ptr<VBO> _instance_vbo = nullptr;
+        size_t _instance_capacity = 0;
+        GLuint _command_buffer = 0;
+        size_t _command_capacity = 0;
+        SSBO _draw_buffer;
+
+        std::unordered_map<Shader*, Uniforms> _uniforms;
+
+        const Uniforms& get_uniforms(Shader& shader) {
+            auto it = _uniforms.find(&shader);
+            if (it != _uniforms.end()) return it->second;
+
+            Uniforms uniforms;
+            uniforms.instanced = shader.getUniform("instanced");
+            uniforms.indirect = shader.getUniform("indirect");
+            uniforms.draw_base = shader.getUniform("draw_base");
+            uniforms.view_projection = shader.getUniform("view_projection");
+            uniforms.camera_position = shader.getUniform("camera_position");
+            return _uniforms.emplace(&shader, uniforms).first->second;
+        }
+
+        /// Grows the instance buffer in place, capacity doubles so resizes stay rare
+        void reserve_instances(size_t count) {
+            if (count <= _instance_capacity && _instance_vbo) return;
+            _instance_capacity = std::max<size_t>(std::max(count, _instance_capacity * 2), 1024);
+            const size_t size = _instance_capacity * sizeof(InstanceBatch::InstanceData);
+            if (_instance_vbo) _instance_vbo->resize(size);
+            else _instance_vbo = std::make_unique<VBO>(nullptr, size, Layout::l_instance, VBO::Mode::DYNAMIC);
+            _dirty = true;
+        }
+
+        void reserve_commands(size_t count) {
+            if (count <= _command_capacity) return;
+            _command_capacity = std::max<size_t>(std::max(count, _command_capacity * 2), 256);
+            glNamedBufferData(_command_buffer, _command_capacity * sizeof(Command), nullptr, GL_DYNAMIC_DRAW);
+            _draw_buffer.reserve(_command_capacity * sizeof(DrawData));
+            _last_commands.clear();
+            _last_draw_data.clear();
+        }
+
+        /// Packs the visible instances of every batch at its command's base instance
+        void upload_instances(StagingRing* staging) {
+            if (_instance_count == 0) return;
+            const size_t size = _instance_count * sizeof(InstanceBatch::InstanceData);
+            const StagingRing::Allocation region = staging ? staging->allocate(size, alignof(InstanceBatch::InstanceData)) : StagingRing::Allocation();
+
+            InstanceBatch::InstanceData* out = nullptr;
+            if (region) {
+                out = reinterpret_cast<InstanceBatch::InstanceData*>(region.data);
+            } else {
+                _instances.resize(_instance_count);
+                out = _instances.data();
+            }
+            for (size_t i = 0; i < _batches.size(); ++i) {
+                _batches[i]->pack_visible(out + _commands[i].base_instance);
+            }
+
+            if (region) {
+                _instance_vbo->replace(staging->getID(), region.offset, size);
+                staging->fence(region);
+            } else {
+                _instance_vbo->replace(_instances.data(), size);
+            }
+        }
+    public:
+        IndirectRenderer() : _draw_buffer(DRAW_DATA_BINDING) {
+            glCreateBuffers(1, &_command_buffer);
+        }
+
+        ~IndirectRenderer() {
+            glDeleteBuffers(1, &_command_buffer);
+        }
+
+        IndirectRenderer(const IndirectRenderer&) = delete;
+        IndirectRenderer& operator=(const IndirectRenderer&) = delete;
+
+        /// glMultiDrawElementsIndirect is core since GL 4.3, the gl_DrawID the shaders fetch materials with since 4.6.
+        /// Contexts without both draw batch by batch
+        static bool is_supported() {
+            return GLAD_GL_VERSION_4_3 && Shader::supportsDrawID();
+        }
+
+        /// Forgets batches and shaders, call whenever the scene rebuilds its batches
+        void invalidate() {
+            _last_batches.clear();
+            _uniforms.clear();
+            _dirty = true;
+        }
+
+        void begin() {
+            _batches.clear();
+            _commands.clear();
+            _draw_data.clear();
+            _runs.clear();
+            _instance_count = 0;
+        }
+
+        /// Adds a batch with `visible` instances marked since its begin_cull(), in the order they should be drawn
+        void add(InstanceBatch& batch, size_t visible) {
+            const InstanceBatch::Key key = batch.get_key();
+            _dirty |= batch.needs_upload();
+
+            const GeometryArena::Range& range = batch.get_geometry()->get_range();
+            _batches.push_back(&batch);
+            _commands.push_back({
+                range.count,
+                static_cast<GLuint>(visible),
+                range.first_index,
+                range.base_vertex,
+                static_cast<GLuint>(_instance_count)
+            });
+            _draw_data.push_back({ key.material->ambient_factor, key.material->diffuse_factor, key.material->specular_factor, key.material->shininess });
+            _instance_count += visible;
+        }
+
+        /// Uploads what changed since the last frame and issues one multi-draw per run of batches with equal state
+        void draw(StateCache& state, StagingRing* staging = nullptr) {
+            if (_commands.empty()) return;
+
+            reserve_instances(_instance_count);
+            reserve_commands(_commands.size());
+            // Instances are re-packed only if a batch changed or the batches moved to other base instances
+            if (_dirty || _batches != _last_batches) {
+                upload_instances(staging);
+                _last_batches = _batches;
+                _dirty = false;
+            }
+            const bool commands_changed = _commands.size() != _last_commands.size()
+                || std::memcmp(_commands.data(), _last_commands.data(), _commands.size() * sizeof(Command)) != 0;
+            if (commands_changed) {
+                glNamedBufferSubData(_command_buffer, 0, _commands.size() * sizeof(Command), _commands.data());
+                _last_commands = _commands;
+            }
+            const bool draw_data_changed = _draw_data.size() != _last_draw_data.size()
+                || std::memcmp(_draw_data.data(), _last_draw_data.data(), _draw_data.size() * sizeof(DrawData)) != 0;
+            if (draw_data_changed) {
+                _draw_buffer.set_data(_draw_data.data(), _draw_data.size() * sizeof(DrawData));
+                _last_draw_data = _draw_data;
+            }
+            _draw_buffer.bind();
+
+            for (size_t i = 0; i < _batches.size(); ++i) {
+                if (!_runs.empty()) {
+                    const InstanceBatch::Key first = _runs.back().batch->get_key();
+                    const InstanceBatch::Key key = _batches[i]->get_key();
+                    if (key.shader == first.shader && key.texture == first.texture && key.cull_face == first.cull_face
+                        && &key.geometry->get_arena() == &first.geometry->get_arena()) {
+                        ++_runs.back().count;
+                        continue;
+                    }
+                }
+                _runs.push_back({ _batches[i], i, 1 });
+            }
+
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, _command_buffer);
+            for (const Run& run : _runs) {
+                const InstanceBatch::Key key = run.batch->get_key();
+                Shader& shader = *run.batch->get_shader();
+                const Uniforms& uniforms = get_uniforms(shader);
+
+                if (state.use_program(shader.getID())) {
+                    shader.setUniform(uniforms.instanced, 1);
+                    shader.setUniform(uniforms.indirect, 1);
+                    shader.setUniform(uniforms.view_projection, CurrentCamera::get_view_proj_matrix());
+                    shader.setUniform(uniforms.camera_position, CurrentCamera::get_position());
+                }
+                // gl_DrawID restarts at zero for every call
+                shader.setUniform(uniforms.draw_base, static_cast<GLint>(run.first));
+                state.bind_texture(0, key.texture->getID());
+                state.set_cull_face(key.cull_face);
+                VAO& vao = key.geometry->get_arena().get_vao(Layout::l_instance);
+                state.bind_vao(vao.getID());
+                vao.setVertexBuffer(1, *_instance_vbo);
+
+                glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, reinterpret_cast<const void*>(run.first * sizeof(Command)),
+                    static_cast<GLsizei>(run.count), 0);
+            }
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        }
+
+        size_t get_call_count() const {
+            return _runs.size();
+        }
+    };
+}
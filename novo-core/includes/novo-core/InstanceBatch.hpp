@@ -0,0 +1,246 @@
+#pragma once
+
+#include <novo-core/Geometry.hpp>
+#include <novo-core/Shader.hpp>
+#include <novo-core/Texture2D.hpp>
+#include <novo-core/Material.hpp>
+#include <novo-core/CurrentCamera.hpp>
+#include <novo-core/StateCache.hpp>
+#include <novo-core/StagingRing.hpp>
+#include <novo-core/Mesh/MeshBase.hpp>
+
+#include <novo-precompiles/Layouts.h>
+
+#include <memory>
+#include <vector>
+#include <cstring>
+
+namespace Novo {
+    /// Meshes sharing geometry, shader, texture, material and cull state, drawn with one glDrawElementsInstancedBaseVertex call
+    class InstanceBatch {
+    public:
+        struct Key {
+            Geometry* geometry;
+            Shader* shader;
+            Texture2D* texture;
+            Material* material;
+            GLenum cull_face;
+
+            bool operator<(const Key& other) const {
+                if (geometry != other.geometry) return geometry < other.geometry;
+                if (shader != other.shader) return shader < other.shader;
+                if (texture != other.texture) return texture < other.texture;
+                if (material != other.material) return material < other.material;
+                return cull_face < other.cull_face;
+            }
+
+            bool operator==(const Key& other) const {
+                return !(*this < other) && !(other < *this);
+            }
+        };
+
+        /// Per-instance vertex data, matches Layout::l_instance
+        struct InstanceData {
+            glm::mat4 model;
+            glm::vec2 uv;
+            glm::mat3 normal;
+        };
+    private:
+        std::shared_ptr<Geometry> _geometry;
+        std::shared_ptr<Shader> _shader;
+        std::shared_ptr<Texture2D> _texture;
+        std::shared_ptr<Material> _material;
+        GLenum _cull_face;
+
+        std::vector<InstanceData> _instances;
+
+        std::vector<uint8_t> _visible_mask;
+        std::vector<uint8_t> _last_mask;
+        std::vector<InstanceData> _visible;
+        size_t _visible_count = 0;
+
+        std::unique_ptr<VBO> _instance_vbo = nullptr;
+        bool _needs_rebuild = true;
+        bool _needs_upload = true;
+
+        struct Uniforms {
+            UniformHandle instanced;
+            UniformHandle indirect;
+            UniformHandle view_projection;
+            UniformHandle camera_position;
+            UniformHandle ambient_factor;
+            UniformHandle diffuse_factor;
+            UniformHandle specular_factor;
+            UniformHandle shininess;
+        } _uniforms;
+
+
+        /// Sizes the instance buffer for every mesh of the batch, a grown batch reallocates the buffer in place
+        void rebuild() {
+            const size_t size = _instances.size() * sizeof(InstanceData);
+            if (!_instance_vbo) {
+                _instance_vbo = std::make_unique<VBO>(nullptr, size, Layout::l_instance, VBO::Mode::DYNAMIC);
+            } else if (_instance_vbo->get_size() < size) {
+                _instance_vbo->resize(size);
+            }
+            _last_mask.clear();
+            _needs_rebuild = false;
+            _needs_upload = true;
+        }
+
+        /// Packs the visible instances to the front of the buffer.
+        /// With a staging ring they are packed straight into mapped memory and copied on the GPU
+        void upload(StagingRing* staging) {
+            _visible_count = 0;
+            for (uint8_t visible : _visible_mask) _visible_count += visible;
+            _last_mask = _visible_mask;
+            _needs_upload = false;
+            if (_visible_count == 0) return;
+
+            const size_t size = _visible_count * sizeof(InstanceData);
+            const StagingRing::Allocation region = staging ? staging->allocate(size, alignof(InstanceData)) : StagingRing::Allocation();
+            if (region) {
+                InstanceData* out = reinterpret_cast<InstanceData*>(region.data);
+                for (size_t i = 0; i < _instances.size(); ++i) {
+                    if (_visible_mask[i]) *out++ = _instances[i];
+                }
+                _instance_vbo->replace(staging->getID(), region.offset, size);
+                staging->fence(region);
+                return;
+            }
+
+            _visible.clear();
+            for (size_t i = 0; i < _instances.size(); ++i) {
+                if (_visible_mask[i]) _visible.push_back(_instances[i]);
+            }
+            _instance_vbo->replace(_visible.data(), size);
+        }
+    public:
+        InstanceBatch(Mesh::MeshBase& mesh)
+            : _geometry(mesh.get_geometry()),
+              _shader(mesh.get_shader()),
+              _texture(mesh.get_texture()),
+              _material(mesh.get_material()),
+              _cull_face(mesh.get_cull_face()) {
+            _uniforms.instanced = _shader->getUniform("instanced");
+            _uniforms.indirect = _shader->getUniform("indirect");
+            _uniforms.view_projection = _shader->getUniform("view_projection");
+            _uniforms.camera_position = _shader->getUniform("camera_position");
+            _uniforms.ambient_factor = _shader->getUniform("ambient_factor");
+            _uniforms.diffuse_factor = _shader->getUniform("diffuse_factor");
+            _uniforms.specular_factor = _shader->getUniform("specular_factor");
+            _uniforms.shininess = _shader->getUniform("shininess");
+        }
+
+        static Key make_key(Mesh::MeshBase& mesh) {
+            return { mesh.get_geometry().get(), mesh.get_shader().get(), mesh.get_texture().get(), mesh.get_material().get(), mesh.get_cull_face() };
+        }
+
+        /// @param model, normal world matrices of the mesh's entity, later changes come through set_transform() and set_uv()
+        /// @return index of the mesh inside the batch, used by mark_visible()
+        size_t add(Mesh::MeshBase& mesh, const glm::mat4& model, const glm::mat3& normal) {
+            _instances.push_back({ model, mesh.get_uv(), normal });
+            _needs_rebuild = true;
+            return _instances.size() - 1;
+        }
+
+        void set_uv(size_t index, glm::vec2 uv) {
+            _instances[index].uv = uv;
+            _needs_upload = true;
+        }
+
+        void set_transform(size_t index, const glm::mat4& model, const glm::mat3& normal) {
+            _instances[index].model = model;
+            _instances[index].normal = normal;
+            _needs_upload = true;
+        }
+
+        /// Hides every instance until it is marked visible again
+        void begin_cull() {
+            _visible_mask.assign(_instances.size(), 0);
+        }
+
+        void mark_visible(size_t index) {
+            _visible_mask[index] = 1;
+        }
+
+        /// The instance buffer is re-packed only if the visible set changed since the last draw
+        /// @return number of visible instances
+        size_t end_cull() {
+            if (_last_mask.size() != _visible_mask.size() || std::memcmp(_last_mask.data(), _visible_mask.data(), _visible_mask.size()) != 0) {
+                _needs_upload = true;
+            }
+
+            size_t count = 0;
+            for (uint8_t visible : _visible_mask) count += visible;
+            return count;
+        }
+
+        /// Issues the instanced draw of the instances marked visible since begin_cull(), only changing the GL state that differs from `state`
+        /// @param staging ring for instance data uploads, nullptr uploads from client memory
+        void draw(StateCache& state, StagingRing* staging = nullptr) {
+            if (_instances.empty()) return;
+            if (_needs_rebuild) rebuild();
+            if (_visible_mask.size() != _instances.size()) _visible_mask.assign(_instances.size(), 1);
+            if (_needs_upload) upload(staging);
+            if (_visible_count == 0) return;
+
+            if (state.use_program(_shader->getID())) {
+                _shader->setUniform(_uniforms.instanced, 1);
+                _shader->setUniform(_uniforms.indirect, 0);
+                _shader->setUniform(_uniforms.view_projection, CurrentCamera::get_view_proj_matrix());
+                _shader->setUniform(_uniforms.camera_position, CurrentCamera::get_position());
+            }
+            if (state.use_material(_material.get())) {
+                _shader->setUniform(_uniforms.ambient_factor, _material->ambient_factor);
+                _shader->setUniform(_uniforms.diffuse_factor, _material->diffuse_factor);
+                _shader->setUniform(_uniforms.specular_factor, _material->specular_factor);
+                _shader->setUniform(_uniforms.shininess, _material->shininess);
+            }
+            state.bind_texture(0, _texture->getID());
+            state.set_cull_face(_cull_face);
+            // All batches of the arena share its instanced VAO, only the instance buffer binding changes between them
+            VAO& vao = _geometry->get_arena().get_vao(Layout::l_instance);
+            state.bind_vao(vao.getID());
+            vao.setVertexBuffer(1, *_instance_vbo);
+
+            const GeometryArena::Range& range = _geometry->get_range();
+            glDrawElementsInstancedBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(range.count), GL_UNSIGNED_INT, range.get_index_offset(),
+                static_cast<GLsizei>(_visible_count), range.base_vertex);
+        }
+
+        /// Whether the visible instances changed since they were last uploaded or packed
+        bool needs_upload() const {
+            return _needs_upload || _visible_mask.size() != _instances.size();
+        }
+
+        /// Writes the visible instances to `out` for a renderer that keeps them in its own buffer, the batch's buffer stays unused
+        /// @return number of instances written
+        size_t pack_visible(InstanceData* out) {
+            if (_visible_mask.size() != _instances.size()) _visible_mask.assign(_instances.size(), 1);
+            size_t count = 0;
+            for (size_t i = 0; i < _instances.size(); ++i) {
+                if (_visible_mask[i]) out[count++] = _instances[i];
+            }
+            _last_mask = _visible_mask;
+            _needs_upload = false;
+            return count;
+        }
+
+        const std::shared_ptr<Geometry>& get_geometry() const {
+            return _geometry;
+        }
+
+        const std::shared_ptr<Shader>& get_shader() const {
+            return _shader;
+        }
+
+        Key get_key() const {
+            return { _geometry.get(), _shader.get(), _texture.get(), _material.get(), _cull_face };
+        }
+
+        size_t get_count() const {
+            return _instances.size();
+        }
+    };
+}
@@ -0,0 +1,300 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Novo {
+    /// Thread pool with one job deque per worker. Workers pop their own deque from the back and steal from the front of others.
+    /// Threads that wait on jobs (e.g. parallel_for() on the GL thread) run queued jobs meanwhile instead of blocking
+    class JobSystem {
+    public:
+        using Job = std::function<void()>;
+
+        /// Number of unfinished jobs of a group. Jobs submitted with submit_after() start once it drops to zero
+        class Counter {
+        private:
+            std::atomic<size_t> _pending = 0;
+            std::mutex _mutex;
+            std::vector<Job> _continuations;
+
+            friend class JobSystem;
+        public:
+            bool is_done() const {
+                return _pending == 0;
+            }
+
+            size_t get_pending() const {
+                return _pending;
+            }
+        };
+        using CounterPtr = std::shared_ptr<Counter>;
+    private:
+        struct Worker {
+            std::deque<Job> jobs;
+            std::mutex mutex;
+        };
+
+        std::vector<std::unique_ptr<Worker>> _workers; // Last one belongs to threads outside the pool
+        std::vector<std::thread> _threads;
+
+        std::atomic<bool> _running = true;
+        std::atomic<size_t> _queued = 0;
+        std::atomic<size_t> _sleeping = 0;
+        std::atomic<size_t> _next = 0; // Round robin target for jobs pushed from outside the pool
+        std::mutex _sleep_mutex;
+        std::condition_variable _wake;
+        static constexpr size_t SPIN_COUNT = 64;
+
+        std::thread::id _main_thread = std::this_thread::get_id();
+        std::deque<Job> _main_jobs;
+        std::mutex _main_mutex;
+
+        static int& worker_index() {
+            static thread_local int index = -1;
+            return index;
+        }
+
+        bool pop(size_t index, Job& job) {
+            Worker& worker = *_workers[index];
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            if (worker.jobs.empty()) return false;
+            job = std::move(worker.jobs.back());
+            worker.jobs.pop_back();
+            return true;
+        }
+
+        bool steal(size_t index, Job& job) {
+            Worker& worker = *_workers[index];
+            std::unique_lock<std::mutex> lock(worker.mutex, std::try_to_lock);
+            if (!lock.owns_lock() || worker.jobs.empty()) return false;
+            job = std::move(worker.jobs.front());
+            worker.jobs.pop_front();
+            return true;
+        }
+
+        /// Own deque first, then the others starting from the right neighbour
+        bool find_job(size_t own, Job& job) {
+            if (pop(own, job)) return true;
+            for (size_t i = 1; i < _workers.size(); ++i) {
+                if (steal((own + i) % _workers.size(), job)) return true;
+            }
+            return false;
+        }
+
+        void worker_loop(size_t index) {
+            worker_index() = static_cast<int>(index);
+            Job job;
+            size_t idle = 0;
+            while (_running) {
+                if (find_job(index, job)) {
+                    --_queued;
+                    job();
+                    idle = 0;
+                    continue;
+                }
+
+                // Spin shortly before sleeping, new jobs often arrive right after a batch ends
+                if (++idle < SPIN_COUNT) {
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                std::unique_lock<std::mutex> lock(_sleep_mutex);
+                ++_sleeping;
+                _wake.wait(lock, [this] { return !_running || _queued > 0; });
+                --_sleeping;
+                idle = 0;
+            }
+        }
+
+        /// Wraps a job so it releases its counter when done. The job keeps the counter alive
+        Job track(Job job, const CounterPtr& counter) {
+            if (!counter) return job;
+            ++counter->_pending;
+            return [this, job = std::move(job), counter] {
+                job();
+                finish(*counter);
+            };
+        }
+
+        void finish(Counter& counter) {
+            if (--counter._pending != 0) return;
+
+            std::vector<Job> continuations;
+            {
+                std::lock_guard<std::mutex> lock(counter._mutex);
+                continuations.swap(counter._continuations);
+            }
+            for (auto& job : continuations) {
+                submit(std::move(job));
+            }
+        }
+
+        size_t own_queue() const {
+            const int index = worker_index();
+            return index >= 0 && static_cast<size_t>(index) < _threads.size() ? static_cast<size_t>(index) : _threads.size();
+        }
+    public:
+        /// @param threads worker count, defaults to one less than the hardware threads so the GL thread keeps a core
+        explicit JobSystem(size_t threads = std::max(1u, std::thread::hardware_concurrency()) - 1) {
+            threads = std::max<size_t>(threads, 1);
+            for (size_t i = 0; i <= threads; ++i) {
+                _workers.push_back(std::make_unique<Worker>());
+            }
+            for (size_t i = 0; i < threads; ++i) {
+                _threads.emplace_back(&JobSystem::worker_loop, this, i);
+            }
+        }
+
+        ~JobSystem() {
+            {
+                std::lock_guard<std::mutex> lock(_sleep_mutex);
+                _running = false;
+            }
+            _wake.notify_all();
+            for (auto& thread : _threads) {
+                thread.join();
+            }
+        }
+
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+
+        /// @param counter incremented now, decremented when the job finishes
+        void submit(Job job, const CounterPtr& counter) {
+            submit(track(std::move(job), counter));
+        }
+
+        /// Queues `job` once `dependency` has no pending jobs left
+        void submit_after(const CounterPtr& dependency, Job job, const CounterPtr& counter = nullptr) {
+            job = track(std::move(job), counter);
+            {
+                std::lock_guard<std::mutex> lock(dependency->_mutex);
+                if (dependency->_pending != 0) {
+                    dependency->_continuations.push_back(std::move(job));
+                    return;
+                }
+            }
+            submit(std::move(job));
+        }
+
+        /// Queues a job that only the main (GL context) thread runs, from run_main_jobs() or while it waits
+        void submit_main(Job job, const CounterPtr& counter = nullptr) {
+            job = track(std::move(job), counter);
+            std::lock_guard<std::mutex> lock(_main_mutex);
+            _main_jobs.push_back(std::move(job));
+        }
+
+        /// Runs main thread jobs until the queue is empty or `budget` has passed. Call once per frame from the GL thread
+        /// @param budget in the clock's own unit, a coarser max() would overflow when converted for the comparison
+        /// @return number of jobs run
+        size_t run_main_jobs(std::chrono::steady_clock::duration budget = std::chrono::steady_clock::duration::max()) {
+            const auto start = std::chrono::steady_clock::now();
+            size_t count = 0;
+            while (true) {
+                Job job;
+                {
+                    std::lock_guard<std::mutex> lock(_main_mutex);
+                    if (_main_jobs.empty()) break;
+                    job = std::move(_main_jobs.front());
+                    _main_jobs.pop_front();
+                }
+                job();
+                ++count;
+                if (std::chrono::steady_clock::now() - start >= budget) break;
+            }
+            return count;
+        }
+
+        /// Thread that runs submit_main() jobs, the one that created the job system by default
+        void set_main_thread(std::thread::id id = std::this_thread::get_id()) {
+            _main_thread = id;
+        }
+
+        bool is_main_thread() const {
+            return std::this_thread::get_id() == _main_thread;
+        }
+
+        CounterPtr make_counter() const {
+            return std::make_shared<Counter>();
+        }
+
+        /// Runs queued jobs on the calling thread until `counter` is done. The main thread also runs its pinned jobs
+        void wait(const CounterPtr& counter) {
+            const bool main = is_main_thread();
+            while (!counter->is_done()) {
+                if (run_one()) continue;
+                if (main && run_main_jobs(std::chrono::microseconds(0)) > 0) continue;
+                std::this_thread::yield();
+            }
+        }
+
+        /// Queues a job on the calling worker's deque, jobs from other threads are spread over the workers
+        void submit(Job job) {
+            size_t index = own_queue();
+            if (index == _threads.size()) {
+                index = _next++ % _threads.size();
+            }
+            ++_queued;
+            {
+                std::lock_guard<std::mutex> lock(_workers[index]->mutex);
+                _workers[index]->jobs.push_back(std::move(job));
+            }
+
+            // A worker going to sleep either sees _queued > 0 or is counted in _sleeping before this check
+            if (_sleeping > 0) {
+                { std::lock_guard<std::mutex> lock(_sleep_mutex); }
+                _wake.notify_one();
+            }
+        }
+
+        /// Runs one queued job on the calling thread
+        /// @return false if there was nothing to run
+        bool run_one() {
+            Job job;
+            if (!find_job(own_queue(), job)) return false;
+            --_queued;
+            job();
+            return true;
+        }
+
+        /// Calls `body(begin, end)` over [0, count) in chunks of at most `grain` items and returns when all chunks are done.
+        /// The calling thread runs chunks too
+        template <typename Body>
+        void parallel_for(size_t count, size_t grain, Body&& body) {
+            if (count == 0) return;
+            grain = std::max<size_t>(grain, 1);
+            const size_t chunks = (count + grain - 1) / grain;
+            if (chunks == 1) {
+                body(size_t(0), count);
+                return;
+            }
+
+            std::atomic<size_t> remaining = chunks;
+            for (size_t chunk = 1; chunk < chunks; ++chunk) {
+                submit([&, chunk] {
+                    body(chunk * grain, std::min(count, (chunk + 1) * grain));
+                    --remaining;
+                });
+            }
+            body(size_t(0), std::min(count, grain));
+            --remaining;
+
+            while (remaining > 0) {
+                if (!run_one()) std::this_thread::yield();
+            }
+        }
+
+        size_t get_thread_count() const {
+            return _threads.size();
+        }
+    };
+}
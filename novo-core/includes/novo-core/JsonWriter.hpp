@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Novo {
+    /// Writes JSON straight to a stream without building a document. Commas are inserted automatically
+    class JsonWriter {
+    private:
+        std::ostream& _out;
+        std::vector<bool> _first; // Per open container, whether nothing was written into it yet
+        bool _after_key = false;
+        bool _newline = false;
+
+        void separate() {
+            if (_after_key) {
+                _after_key = false;
+                return;
+            }
+            if (!_first.empty()) {
+                if (!_first.back()) _out.put(',');
+                _first.back() = false;
+            }
+            flush_newline();
+        }
+
+        void flush_newline() {
+            if (_newline) _out.put('\n');
+            _newline = false;
+        }
+
+        void write_escaped(const std::string& value) {
+            _out.put('"');
+            size_t start = 0;
+            for (size_t i = 0; i < value.size(); ++i) {
+                const unsigned char c = static_cast<unsigned char>(value[i]);
+                if (c != '"' && c != '\\' && c >= 0x20) continue;
+
+                _out.write(value.data() + start, i - start);
+                start = i + 1;
+                switch (c) {
+                    case '"': _out << "\\\""; break;
+                    case '\\': _out << "\\\\"; break;
+                    case '\n': _out << "\\n"; break;
+                    case '\r': _out << "\\r"; break;
+                    case '\t': _out << "\\t"; break;
+                    default: {
+                        char buffer[8];
+                        std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                        _out << buffer;
+                    }
+                }
+            }
+            _out.write(value.data() + start, value.size() - start);
+            _out.put('"');
+        }
+    public:
+        explicit JsonWriter(std::ostream& out) : _out(out) {}
+
+        JsonWriter& begin_object() {
+            separate();
+            _out.put('{');
+            _first.push_back(true);
+            return *this;
+        }
+
+        JsonWriter& end_object() {
+            flush_newline();
+            _first.pop_back();
+            _out.put('}');
+            return *this;
+        }
+
+        JsonWriter& begin_array() {
+            separate();
+            _out.put('[');
+            _first.push_back(true);
+            return *this;
+        }
+
+        JsonWriter& end_array() {
+            flush_newline();
+            _first.pop_back();
+            _out.put(']');
+            return *this;
+        }
+
+        JsonWriter& key(const std::string& name) {
+            separate();
+            write_escaped(name);
+            _out.put(':');
+            _after_key = true;
+            return *this;
+        }
+
+        JsonWriter& value(const std::string& text) {
+            separate();
+            write_escaped(text);
+            return *this;
+        }
+
+        JsonWriter& value(const char* text) {
+            return value(std::string(text));
+        }
+
+        JsonWriter& value(int number) {
+            separate();
+            _out << number;
+            return *this;
+        }
+
+        /// Non finite numbers are written as null, JSON has no representation for them
+        JsonWriter& value(float number) {
+            separate();
+            if (!std::isfinite(number)) {
+                _out << "null";
+                return *this;
+            }
+            // Shortest precision that reads back to the same float, 9 digits always do
+            char buffer[32];
+            int length = 0;
+            for (int precision = 6; precision <= 9; ++precision) {
+                length = std::snprintf(buffer, sizeof(buffer), "%.*g", precision, number);
+                if (std::strtof(buffer, nullptr) == number) break;
+            }
+            _out.write(buffer, length);
+            return *this;
+        }
+
+        /// Writes `{"x": .., "y": .., "z": ..}` with the given component names
+        template <typename Vector>
+        JsonWriter& vec3(const Vector& vector, const char* x = "x", const char* y = "y", const char* z = "z") {
+            begin_object();
+            key(x).value(static_cast<float>(vector[0]));
+            key(y).value(static_cast<float>(vector[1]));
+            key(z).value(static_cast<float>(vector[2]));
+            return end_object();
+        }
+
+        /// Line break before the next entry (after its comma), keeps big files diffable
+        JsonWriter& newline() {
+            if (_first.empty()) {
+                _out.put('\n');
+            } else {
+                _newline = true;
+            }
+            return *this;
+        }
+    };
+}
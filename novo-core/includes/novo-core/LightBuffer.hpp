@@ -0,0 +1,74 @@
+#pragma once
+
+#include <novo-core/SSBO.hpp>
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstring>
+
+namespace Novo {
+    /// Packed list of active lights shared by every shader through
+    /// `layout(std430, binding = 0) buffer LightBuffer` (see object.frag).
+    class LightBuffer {
+    public:
+        static constexpr GLuint BINDING = 0;
+
+        struct LightData {
+            glm::vec4 position; // XYZ - position, W - radius
+            glm::vec4 color;    // RGB - color
+        };
+    private:
+        struct Header {
+            glm::vec4 ambient_color; // Sum of all active light colors, lights contribute ambient regardless of range
+            GLuint light_count;
+            GLuint padding[3];
+        };
+
+        std::vector<LightData> _lights;
+        std::vector<LightData> _uploaded;
+        bool _uploadedOnce = false;
+        SSBO _ssbo;
+    public:
+        LightBuffer() : _ssbo(BINDING, sizeof(Header)) {}
+
+        void clear() {
+            _lights.clear();
+        }
+
+        void add_light(const glm::vec3& position, const glm::vec3& color, const float radius) {
+            _lights.push_back({glm::vec4(position, radius), glm::vec4(color, 1.f)});
+        }
+
+        /// Sends the staged lights to the GPU. Does nothing if they haven't changed since the last upload.
+        void upload() {
+            if (_uploadedOnce && _lights.size() == _uploaded.size() &&
+                std::memcmp(_lights.data(), _uploaded.data(), _lights.size() * sizeof(LightData)) == 0) {
+                return;
+            }
+
+            const size_t size = sizeof(Header) + _lights.size() * sizeof(LightData);
+            _ssbo.reserve(size);
+
+            Header header = { glm::vec4(0.f), static_cast<GLuint>(_lights.size()), {0, 0, 0} };
+            for (auto& light : _lights) {
+                header.ambient_color += light.color;
+            }
+            _ssbo.set_data(&header, sizeof(Header));
+            _ssbo.set_data(_lights.data(), _lights.size() * sizeof(LightData), sizeof(Header));
+
+            _uploaded = _lights;
+            _uploadedOnce = true;
+        }
+
+        void bind() const {
+            _ssbo.bind();
+        }
+
+        const std::vector<LightData>& get_lights() const {
+            return _lights;
+        }
+
+        size_t get_count() const {
+            return _lights.size();
+        }
+    };
+}
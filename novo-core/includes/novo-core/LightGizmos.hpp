@@ -0,0 +1,128 @@
+#pragma once
+
+#include <novo-core/Geometry.hpp>
+#include <novo-core/VAO.hpp>
+#include <novo-core/Shader.hpp>
+#include <novo-core/CurrentCamera.hpp>
+#include <novo-core/StateCache.hpp>
+#include <novo-core/Mesh/Box.hpp>
+
+#include <novo-precompiles/Layouts.h>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace Novo {
+    /// Draws the cube gizmos of all lights with one instanced call per light shader, usually a single draw for the whole scene
+    class LightGizmos {
+    public:
+        /// Per-instance vertex data, matches Layout::l_light_instance
+        struct InstanceData {
+            glm::mat4 model;
+            glm::vec3 color;
+        };
+    private:
+        struct Entry {
+            Shader* shader;
+            InstanceData instance;
+        };
+
+        struct Uniforms {
+            UniformHandle instanced;
+            UniformHandle view_projection;
+        };
+
+        std::shared_ptr<Geometry> _geometry;
+        std::vector<Entry> _entries;
+        std::vector<InstanceData> _instances;
+        std::vector<InstanceData> _uploaded; // What the VBO holds, lights that didn't change aren't uploaded again
+        std::unordered_map<Shader*, Uniforms> _uniforms;
+
+        std::unique_ptr<VBO> _instance_vbo = nullptr;
+        size_t _capacity = 0; // Instances the VBO can hold
+
+        /// Grows the instance buffer to hold at least `count` instances, capacity doubles so resizes stay rare
+        void reserve(size_t count) {
+            if (count > _capacity || !_instance_vbo) {
+                _capacity = std::max<size_t>(std::max(count, _capacity * 2), 16);
+                if (_instance_vbo) _instance_vbo->resize(_capacity * sizeof(InstanceData));
+                else _instance_vbo = std::make_unique<VBO>(nullptr, _capacity * sizeof(InstanceData), Layout::l_light_instance, VBO::Mode::DYNAMIC);
+                _uploaded.clear();
+            }
+        }
+
+        const Uniforms& get_uniforms(Shader& shader) {
+            auto it = _uniforms.find(&shader);
+            if (it != _uniforms.end()) return it->second;
+
+            Uniforms uniforms;
+            uniforms.instanced = shader.getUniform("instanced");
+            uniforms.view_projection = shader.getUniform("view_projection");
+            return _uniforms.emplace(&shader, uniforms).first->second;
+        }
+    public:
+        LightGizmos() = default;
+
+        void clear() {
+            _entries.clear();
+        }
+
+        /// Forgets shaders and uploaded instances, call when shaders may have been destroyed
+        void invalidate() {
+            _uniforms.clear();
+            _uploaded.clear();
+        }
+
+        void add(Shader& shader, const glm::mat4& model, const glm::vec3& color) {
+            _entries.push_back({ &shader, { model, color } });
+        }
+
+        size_t get_count() const {
+            return _entries.size();
+        }
+
+        /// Uploads the gizmos added since clear() and draws them, only changing the GL state that differs from `state`
+        void draw(StateCache& state) {
+            if (_entries.empty()) return;
+            if (!_geometry) _geometry = Mesh::Box::get_geometry(false);
+
+            // Lights sharing a shader become one contiguous instance range
+            std::stable_sort(_entries.begin(), _entries.end(), [](const Entry& a, const Entry& b) { return a.shader < b.shader; });
+            _instances.clear();
+            for (const Entry& entry : _entries) _instances.push_back(entry.instance);
+
+            reserve(_instances.size());
+            const bool changed = _instances.size() != _uploaded.size()
+                || std::memcmp(_instances.data(), _uploaded.data(), _instances.size() * sizeof(InstanceData)) != 0;
+            if (changed) {
+                _instance_vbo->replace(_instances.data(), _instances.size() * sizeof(InstanceData));
+                _uploaded = _instances;
+            }
+
+            state.set_cull_face(GL_FRONT); // Same as MeshBase::get_cull_face(), the cube is wound inside out
+            VAO& vao = _geometry->get_arena().get_vao(Layout::l_light_instance);
+            state.bind_vao(vao.getID());
+            vao.setVertexBuffer(1, *_instance_vbo);
+
+            size_t begin = 0;
+            while (begin < _entries.size()) {
+                Shader& shader = *_entries[begin].shader;
+                size_t end = begin + 1;
+                while (end < _entries.size() && _entries[end].shader == &shader) ++end;
+
+                if (state.use_program(shader.getID())) {
+                    const Uniforms& uniforms = get_uniforms(shader);
+                    shader.setUniform(uniforms.instanced, 1);
+                    shader.setUniform(uniforms.view_projection, CurrentCamera::get_view_proj_matrix());
+                }
+                const GeometryArena::Range& range = _geometry->get_range();
+                glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, static_cast<GLsizei>(range.count), GL_UNSIGNED_INT, range.get_index_offset(),
+                    static_cast<GLsizei>(end - begin), range.base_vertex, static_cast<GLuint>(begin));
+                begin = end;
+            }
+        }
+    };
+}
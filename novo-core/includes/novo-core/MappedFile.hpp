@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Novo {
+    /// Read only memory mapping of a whole file. The pages are loaded by the OS on first access, nothing is copied
+    class MappedFile {
+    private:
+        const unsigned char* _data = nullptr;
+        size_t _size = 0;
+#ifdef _WIN32
+        HANDLE _file = INVALID_HANDLE_VALUE;
+        HANDLE _mapping = nullptr;
+#else
+        int _fd = -1;
+#endif
+    public:
+        explicit MappedFile(const std::string& path) {
+#ifdef _WIN32
+            _file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            LARGE_INTEGER size;
+            if (_file == INVALID_HANDLE_VALUE || !GetFileSizeEx(_file, &size)) {
+                std::cerr << "Failed to open file " << path << std::endl;
+                return;
+            }
+            _size = static_cast<size_t>(size.QuadPart);
+            if (_size == 0) return;
+
+            _mapping = CreateFileMappingA(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (_mapping) {
+                _data = static_cast<const unsigned char*>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+            }
+#else
+            _fd = open(path.c_str(), O_RDONLY);
+            struct stat info;
+            if (_fd < 0 || fstat(_fd, &info) != 0) {
+                std::cerr << "Failed to open file " << path << std::endl;
+                return;
+            }
+            _size = static_cast<size_t>(info.st_size);
+            if (_size == 0) return;
+
+            void* data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, _fd, 0);
+            if (data != MAP_FAILED) {
+                _data = static_cast<const unsigned char*>(data);
+            }
+#endif
+            if (!_data) {
+                std::cerr << "Failed to map file " << path << std::endl;
+                _size = 0;
+            }
+        }
+
+        ~MappedFile() {
+#ifdef _WIN32
+            if (_data) UnmapViewOfFile(_data);
+            if (_mapping) CloseHandle(_mapping);
+            if (_file != INVALID_HANDLE_VALUE) CloseHandle(_file);
+#else
+            if (_data) munmap(const_cast<unsigned char*>(_data), _size);
+            if (_fd >= 0) close(_fd);
+#endif
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        bool is_open() const {
+            return _data != nullptr;
+        }
+
+        const unsigned char* get_data() const {
+            return _data;
+        }
+
+        size_t get_size() const {
+            return _size;
+        }
+    };
+}
@@ -2,84 +2,6 @@
 
 #include <novo-core/Mesh/MeshBase.hpp>
 
-#define VERTIECES_NORMAL_UV { \
-/*  X   Y   Z            NORMAL                  U   V*/    \
-    /* Front */                                             \
-    -1, 1,  -1,      0.0, 0.0,-1.0,         _uv.x,   _uv.y, \
-    -1, -1, -1,      0.0, 0.0,-1.0,         _uv.x,   0.f,   \
-    1, -1,  -1,      0.0, 0.0,-1.0,         0.f,     0.f,   \
-    1,  1,  -1,      0.0, 0.0,-1.0,         0.f,     _uv.y, \
-\
-    /* Back */                       \
-    -1, 1,  1,       0.0, 0.0, 1.0,         -_uv.x,  _uv.y, \
-    1,  1,  1,       0.0, 0.0, 1.0,         0.f,     _uv.y, \
-    1, -1,  1,       0.0, 0.0, 1.0,         0.f,     0.f,   \
-    -1, -1, 1,       0.0, 0.0, 1.0,         -_uv.x,  0.f,   \
-\
-    /* Left */                       \
-    -1,  1, -1,     -1.0, 0.0, 0.0,         -_uv.x,  _uv.y, \
-    -1,  1,  1,     -1.0, 0.0, 0.0,         0.f,     _uv.y, \
-    -1, -1,  1,     -1.0, 0.0, 0.0,         0.f,     0.f,   \
-    -1, -1, -1,     -1.0, 0.0, 0.0,         -_uv.x,  0.f,   \
-\
-    /* Right */                      \
-    1, -1, -1,      1.0, 0.0, 0.0,          _uv.x,   0.f,   \
-    1, -1, 1,       1.0, 0.0, 0.0,          0.f,     0.f,   \
-    1, 1,  1,       1.0, 0.0, 0.0,          0.f,     _uv.y, \
-    1, 1, -1,       1.0, 0.0, 0.0,          _uv.x,   _uv.y, \
-\
-    /* Up */                         \
-    -1, 1, -1,      0.0, 1.0, 0.0,          _uv.x,   0.f,   \
-    1, 1, -1,       0.0, 1.0, 0.0,          0.f,     0.f,   \
-    1,  1, 1,       0.0, 1.0, 0.0,          0.f,     _uv.y, \
-    -1, 1, 1,       0.0, 1.0, 0.0,          _uv.x,   _uv.y, \
-\
-    /* Down */                       \
-    -1, -1, 1,      0.0,-1.0, 0.0,          -_uv.x,  _uv.y, \
-    1, -1, 1,       0.0,-1.0, 0.0,          0.f,     _uv.y, \
-    1, -1, -1,      0.0,-1.0, 0.0,          0.f,     0.f,   \
-    -1, -1, -1,     0.0,-1.0, 0.0,          -_uv.x,  0.f,   \
-}
-
-#define VERTIECES_INVERTED_NORMAL_UV { \
-/*  X   Y   Z            NORMAL                  U   V*/    \
-    /* Front */                                             \
-    -1, 1,  -1,      0.0, 0.0, 1.0,         _uv.x,   _uv.y, \
-    -1, -1, -1,      0.0, 0.0, 1.0,         _uv.x,   0.f,   \
-    1, -1,  -1,      0.0, 0.0, 1.0,         0.f,     0.f,   \
-    1,  1,  -1,      0.0, 0.0, 1.0,         0.f,     _uv.y, \
-\
-    /* Back */                       \
-    -1, 1,  1,       0.0, 0.0,-1.0,         -_uv.x,  _uv.y, \
-    1,  1,  1,       0.0, 0.0,-1.0,         0.f,     _uv.y, \
-    1, -1,  1,       0.0, 0.0,-1.0,         0.f,     0.f,   \
-    -1, -1, 1,       0.0, 0.0,-1.0,         -_uv.x,  0.f,   \
-\
-    /* Left */                       \
-    -1,  1, -1,      1.0, 0.0, 0.0,         -_uv.x,  _uv.y, \
-    -1,  1,  1,      1.0, 0.0, 0.0,         0.f,     _uv.y, \
-    -1, -1,  1,      1.0, 0.0, 0.0,         0.f,     0.f,   \
-    -1, -1, -1,      1.0, 0.0, 0.0,         -_uv.x,  0.f,   \
-\
-    /* Right */                      \
-    1, -1, -1,     -1.0, 0.0, 0.0,          _uv.x,   0.f,   \
-    1, -1, 1,      -1.0, 0.0, 0.0,          0.f,     0.f,   \
-    1, 1,  1,      -1.0, 0.0, 0.0,          0.f,     _uv.y, \
-    1, 1, -1,      -1.0, 0.0, 0.0,          _uv.x,   _uv.y, \
-\
-    /* Up */                         \
-    -1, 1, -1,      0.0,-1.0, 0.0,          _uv.x,   0.f,   \
-    1, 1, -1,       0.0,-1.0, 0.0,          0.f,     0.f,   \
-    1,  1, 1,       0.0,-1.0, 0.0,          0.f,     _uv.y, \
-    -1, 1, 1,       0.0,-1.0, 0.0,          _uv.x,   _uv.y, \
-\
-    /* Down */                       \
-    -1, -1, 1,      0.0, 1.0, 0.0,          -_uv.x,  _uv.y, \
-    1, -1, 1,       0.0, 1.0, 0.0,          0.f,     _uv.y, \
-    1, -1, -1,      0.0, 1.0, 0.0,          0.f,     0.f,   \
-    -1, -1, -1,     0.0, 1.0, 0.0,          -_uv.x,  0.f,   \
-}
-
 namespace Novo {
     namespace Mesh {
         class Box : public MeshBase {
@@ -88,72 +10,125 @@ namespace Novo {
         public:
             Box(std::shared_ptr<Novo::Texture2D> texture, std::shared_ptr<Novo::Shader> shader, std::shared_ptr<Material> material, glm::vec3 position = glm::vec3(0), glm::vec3 size = glm::vec3(1), glm::vec3 rotation = glm::vec3(0))
                : MeshBase(std::move(texture), std::move(shader), std::move(material), position, size, rotation) {
-                GLfloat vertices_uv[] = VERTIECES_NORMAL_UV;
-
-                GLuint indices[] = {
-                    0,  1,  2,  2,  3,  0,  // Front
-                    4,  5,  6,  4,  6,  7,  // Back
-                    8,  9,  10, 8,  10, 11, // Left
-                    12, 13, 14, 12, 14, 15, // Right
-                    16, 17, 18, 16, 18, 19, // Up
-                    20, 21, 22, 20, 22, 23, // Down
-                };
-
-                _vbo = new Novo::VBO(vertices_uv, sizeof(vertices_uv), Novo::Layout::l_texture);
-                _ibo = new Novo::IBO(indices, sizeof(indices) / sizeof(GLuint));
-                _vao = new Novo::VAO();
-                
-                _vao->addVBO(*_vbo);
-                _vao->setIBO(*_ibo);
+                _geometry = get_geometry(false);
             }
 
-            virtual void draw() override {
-                glEnable(GL_CULL_FACE);
-                if (!_inverse) glCullFace(GL_FRONT);
-                else glCullFace(GL_BACK);
-                glFrontFace(GL_CCW);
-                MeshBase::draw();
+            /// Shared cube. UVs are in [-1, 1] and scaled per mesh by the `uv_scale` uniform
+            static std::shared_ptr<Novo::Geometry> get_geometry(bool inverted) {
+                if (!inverted) {
+                    return Novo::GeometryRegistry::get(Novo::GeometryID::Box, [] {
+                        static const GLfloat vertices_uv[] = {
+                        /*  X   Y   Z            NORMAL            U      V  */
+                            /* Front */
+                            -1, 1,  -1,      0.0, 0.0,-1.0,      1.f,   1.f,
+                            -1, -1, -1,      0.0, 0.0,-1.0,      1.f,   0.f,
+                            1, -1,  -1,      0.0, 0.0,-1.0,      0.f,   0.f,
+                            1,  1,  -1,      0.0, 0.0,-1.0,      0.f,   1.f,
+
+                            /* Back */
+                            -1, 1,  1,       0.0, 0.0, 1.0,     -1.f,   1.f,
+                            1,  1,  1,       0.0, 0.0, 1.0,      0.f,   1.f,
+                            1, -1,  1,       0.0, 0.0, 1.0,      0.f,   0.f,
+                            -1, -1, 1,       0.0, 0.0, 1.0,     -1.f,   0.f,
+
+                            /* Left */
+                            -1,  1, -1,     -1.0, 0.0, 0.0,     -1.f,   1.f,
+                            -1,  1,  1,     -1.0, 0.0, 0.0,      0.f,   1.f,
+                            -1, -1,  1,     -1.0, 0.0, 0.0,      0.f,   0.f,
+                            -1, -1, -1,     -1.0, 0.0, 0.0,     -1.f,   0.f,
+
+                            /* Right */
+                            1, -1, -1,       1.0, 0.0, 0.0,      1.f,   0.f,
+                            1, -1, 1,        1.0, 0.0, 0.0,      0.f,   0.f,
+                            1, 1,  1,        1.0, 0.0, 0.0,      0.f,   1.f,
+                            1, 1, -1,        1.0, 0.0, 0.0,      1.f,   1.f,
+
+                            /* Up */
+                            -1, 1, -1,       0.0, 1.0, 0.0,      1.f,   0.f,
+                            1, 1, -1,        0.0, 1.0, 0.0,      0.f,   0.f,
+                            1,  1, 1,        0.0, 1.0, 0.0,      0.f,   1.f,
+                            -1, 1, 1,        0.0, 1.0, 0.0,      1.f,   1.f,
+
+                            /* Down */
+                            -1, -1, 1,       0.0,-1.0, 0.0,     -1.f,   1.f,
+                            1, -1, 1,        0.0,-1.0, 0.0,      0.f,   1.f,
+                            1, -1, -1,       0.0,-1.0, 0.0,      0.f,   0.f,
+                            -1, -1, -1,      0.0,-1.0, 0.0,     -1.f,   0.f,
+                        };
+
+                        return std::make_shared<Novo::Geometry>(vertices_uv, sizeof(vertices_uv), Novo::Layout::l_texture, s_indices, sizeof(s_indices) / sizeof(GLuint));
+                    });
+                }
+
+                return Novo::GeometryRegistry::get(Novo::GeometryID::BoxInverted, [] {
+                    static const GLfloat vertices_uv[] = {
+                    /*  X   Y   Z            NORMAL            U      V  */
+                        /* Front */
+                        -1, 1,  -1,      0.0, 0.0, 1.0,      1.f,   1.f,
+                        -1, -1, -1,      0.0, 0.0, 1.0,      1.f,   0.f,
+                        1, -1,  -1,      0.0, 0.0, 1.0,      0.f,   0.f,
+                        1,  1,  -1,      0.0, 0.0, 1.0,      0.f,   1.f,
+
+                        /* Back */
+                        -1, 1,  1,       0.0, 0.0,-1.0,     -1.f,   1.f,
+                        1,  1,  1,       0.0, 0.0,-1.0,      0.f,   1.f,
+                        1, -1,  1,       0.0, 0.0,-1.0,      0.f,   0.f,
+                        -1, -1, 1,       0.0, 0.0,-1.0,     -1.f,   0.f,
+
+                        /* Left */
+                        -1,  1, -1,      1.0, 0.0, 0.0,     -1.f,   1.f,
+                        -1,  1,  1,      1.0, 0.0, 0.0,      0.f,   1.f,
+                        -1, -1,  1,      1.0, 0.0, 0.0,      0.f,   0.f,
+                        -1, -1, -1,      1.0, 0.0, 0.0,     -1.f,   0.f,
+
+                        /* Right */
+                        1, -1, -1,      -1.0, 0.0, 0.0,      1.f,   0.f,
+                        1, -1, 1,       -1.0, 0.0, 0.0,      0.f,   0.f,
+                        1, 1,  1,       -1.0, 0.0, 0.0,      0.f,   1.f,
+                        1, 1, -1,       -1.0, 0.0, 0.0,      1.f,   1.f,
+
+                        /* Up */
+                        -1, 1, -1,       0.0,-1.0, 0.0,      1.f,   0.f,
+                        1, 1, -1,        0.0,-1.0, 0.0,      0.f,   0.f,
+                        1,  1, 1,        0.0,-1.0, 0.0,      0.f,   1.f,
+                        -1, 1, 1,        0.0,-1.0, 0.0,      1.f,   1.f,
+
+                        /* Down */
+                        -1, -1, 1,       0.0, 1.0, 0.0,     -1.f,   1.f,
+                        1, -1, 1,        0.0, 1.0, 0.0,      0.f,   1.f,
+                        1, -1, -1,       0.0, 1.0, 0.0,      0.f,   0.f,
+                        -1, -1, -1,      0.0, 1.0, 0.0,     -1.f,   0.f,
+                    };
+
+                    return std::make_shared<Novo::Geometry>(vertices_uv, sizeof(vertices_uv), Novo::Layout::l_texture, s_indices, sizeof(s_indices) / sizeof(GLuint));
+                });
             }
 
             void inverse() {
                 _inverse = !_inverse;
-
-                GLfloat new_box[] = VERTIECES_INVERTED_NORMAL_UV;
-
-                delete _vbo;
-                delete _vao;
-
-                _vbo = new Novo::VBO(new_box, sizeof(new_box), Novo::Layout::l_texture);
-                _vao = new Novo::VAO();
-                
-                _vao->addVBO(*_vbo);
-                _vao->setIBO(*_ibo);
+                _geometry = get_geometry(_inverse);
+                touch();
             }
 
+            virtual GLenum get_cull_face() const override { return _inverse ? GL_BACK : GL_FRONT; }
+            virtual bool is_instanceable() const override { return true; }
             virtual const Novo::MeshID get_id() const { return MeshID::Box; }
 
-            virtual void set_uv(glm::vec2 uv) override {
-                _uv = uv;
-                GLfloat new_uv[] = VERTIECES_NORMAL_UV;
-
-                delete _vbo;
-                delete _vao;
-
-                _vbo = new Novo::VBO(new_uv, sizeof(new_uv), Novo::Layout::l_texture);
-                _vao = new Novo::VAO();
-                
-                _vao->addVBO(*_vbo);
-                _vao->setIBO(*_ibo);
-            }
-
             virtual void draw_ui(const std::string& tab_name) override {
                 MeshBase::draw_ui(tab_name);
                 if (ImGui::Button("Inverse")) {
                     inverse();
                 }
             }
+        private:
+            static constexpr GLuint s_indices[] = {
+                0,  1,  2,  2,  3,  0,  // Front
+                4,  5,  6,  4,  6,  7,  // Back
+                8,  9,  10, 8,  10, 11, // Left
+                12, 13, 14, 12, 14, 15, // Right
+                16, 17, 18, 16, 18, 19, // Up
+                20, 21, 22, 20, 22, 23, // Down
+            };
         };
     }
 }
-
-#undef VERTIECES_NORMAL_UV
\ No newline at end of file
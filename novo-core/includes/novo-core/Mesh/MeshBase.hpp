@@ -1,17 +1,17 @@
 #pragma once
 
 #include <novo-core/Shader.hpp>
-#include <novo-core/VBO.hpp>
-#include <novo-core/VAO.hpp>
-#include <novo-core/IBO.hpp>
+#include <novo-core/Geometry.hpp>
 #include <novo-core/Texture2D.hpp>
 #include <novo-core/CurrentCamera.hpp>
 #include <novo-core/Material.hpp>
+#include <novo-core/AABB.hpp>
 #include <novo-core/Mesh/MeshID.hpp>
 
 #include <novo-precompiles/Layouts.h>
 
 #include <memory>
+#include <vector>
 #include <imgui/imgui.h>
 
 
@@ -19,9 +19,7 @@ namespace Novo {
     namespace Mesh {
         class MeshBase {
         protected:
-            Novo::VAO* _vao = nullptr;
-            Novo::VBO* _vbo = nullptr;
-            Novo::IBO* _ibo = nullptr;
+            std::shared_ptr<Novo::Geometry> _geometry = nullptr;
 
             std::shared_ptr<Novo::Shader> _shader = nullptr;
             std::shared_ptr<Novo::Texture2D> _texture = nullptr;
@@ -35,8 +33,59 @@ namespace Novo {
 
 
             bool _draw = true;
+
+            /// Where touch() reports the mesh, set by the scene owning it. Copies of a mesh start unreported
+            struct ChangeList {
+                std::vector<uint32_t>* ids = nullptr;
+                uint32_t id = 0;
+                bool queued = false;
+
+                ChangeList() = default;
+                ChangeList(const ChangeList&) {}
+                ChangeList& operator=(const ChangeList&) { return *this; }
+            } _changes;
+
+            mutable glm::mat4 _model_matrix = glm::mat4(1.f);
+            mutable glm::mat3 _normal_matrix = glm::mat3(1.f);
+            mutable AABB _world_bounds;
+            mutable bool _matrices_dirty = true;
+
+            struct Uniforms {
+                UniformHandle model;
+                UniformHandle normal_matrix;
+                UniformHandle view_projection;
+                UniformHandle camera_position;
+                UniformHandle ambient_factor;
+                UniformHandle diffuse_factor;
+                UniformHandle specular_factor;
+                UniformHandle shininess;
+                UniformHandle uv_scale;
+                UniformHandle instanced;
+                UniformHandle indirect;
+            } _uniforms;
+
+            /// Reports the mesh to its owner, once until the owner takes the change, so scenes only revisit edited meshes
+            void touch() {
+                if (_changes.ids && !_changes.queued) {
+                    _changes.ids->push_back(_changes.id);
+                    _changes.queued = true;
+                }
+            }
+
+            /// Marks the cached matrices as stale, they are rebuilt on the next get_*_matrix() call
+            void touch_transform() {
+                _matrices_dirty = true;
+                touch();
+            }
+
+            void update_matrices() const {
+                compose(_position, _rotation, _size, _model_matrix, _normal_matrix);
+                _world_bounds = get_local_bounds().transform(_model_matrix);
+
+                _matrices_dirty = false;
+            }
         public:
-            /// @warning Don't forget to initialize _vao, _vbo and _ibo
+            /// @warning Don't forget to initialize _geometry
             MeshBase(std::shared_ptr<Novo::Texture2D> texture, std::shared_ptr<Novo::Shader> shader, std::shared_ptr<Material> material, glm::vec3 position = glm::vec3(0), glm::vec3 size = glm::vec3(1), glm::vec3 rotation = glm::vec3(0)) {
                 _texture = texture;
                 _shader = shader;
@@ -46,47 +95,119 @@ namespace Novo {
                 _rotation = rotation;
 
                 _material = material;
+
+                if (_shader) {
+                    _uniforms.model = _shader->getUniform("model");
+                    _uniforms.normal_matrix = _shader->getUniform("normal_matrix");
+                    _uniforms.view_projection = _shader->getUniform("view_projection");
+                    _uniforms.camera_position = _shader->getUniform("camera_position");
+                    _uniforms.ambient_factor = _shader->getUniform("ambient_factor");
+                    _uniforms.diffuse_factor = _shader->getUniform("diffuse_factor");
+                    _uniforms.specular_factor = _shader->getUniform("specular_factor");
+                    _uniforms.shininess = _shader->getUniform("shininess");
+                    _uniforms.uv_scale = _shader->getUniform("uv_scale");
+                    _uniforms.instanced = _shader->getUniform("instanced");
+                    _uniforms.indirect = _shader->getUniform("indirect");
+                }
             };
 
             virtual void draw() {
+                draw(get_model_matrix(), get_normal_matrix());
+            }
+
+            /// Draws with matrices composed elsewhere. Scenes pass the entity's Transform, so nothing is composed on the GL thread
+            virtual void draw(const glm::mat4& model, const glm::mat3& normal) {
                 if (!_draw) return;
+                apply_cull_face(get_cull_face());
                 _shader->load();
                 _texture->bind(0);
-                glm::mat4 model = glm::mat4(1.f);
-                glm::mat4 translate = glm::translate(model, _position);
-                glm::mat4 rotate_x = glm::rotate(glm::mat4(1.f), glm::radians(_rotation.x), glm::vec3(1.f, 0.f, 0.f));
-                glm::mat4 rotate_y = glm::rotate(glm::mat4(1.f), glm::radians(_rotation.y), glm::vec3(0.f, 1.f, 0.f));
-                glm::mat4 rotate_z = glm::rotate(glm::mat4(1.f), glm::radians(_rotation.z), glm::vec3(0.f, 0.f, 1.f));
-                glm::mat4 scale = glm::scale(model, _size);
 
-                model = translate * rotate_x * rotate_y * rotate_z * scale;
+                _shader->setUniform(_uniforms.instanced, 0);
+                _shader->setUniform(_uniforms.indirect, 0);
+                _shader->setUniform(_uniforms.model, model);
+                _shader->setUniform(_uniforms.normal_matrix, normal);
+                _shader->setUniform(_uniforms.view_projection, CurrentCamera::get_view_proj_matrix());
 
-                _shader->setUniform("model", model);
-                _shader->setUniform("view_projection", CurrentCamera::get_view_proj_matrix());
+                _shader->setUniform(_uniforms.camera_position, Novo::CurrentCamera::get_position());
 
-                _shader->setUniform("camera_position", Novo::CurrentCamera::get_position());
+                _shader->setUniform(_uniforms.ambient_factor, _material->ambient_factor);
+                _shader->setUniform(_uniforms.diffuse_factor, _material->diffuse_factor);
+                _shader->setUniform(_uniforms.specular_factor, _material->specular_factor);
+                _shader->setUniform(_uniforms.shininess, _material->shininess);
+                _shader->setUniform(_uniforms.uv_scale, _uv);
 
-                _shader->setUniform("ambient_factor", _material->ambient_factor);
-                _shader->setUniform("diffuse_factor", _material->diffuse_factor);
-                _shader->setUniform("specular_factor", _material->specular_factor);
-                _shader->setUniform("shininess", _material->shininess);
-
-                _vao->draw();
+                _geometry->draw();
                 _shader->unload();
             }
 
-            virtual void set_uv(glm::vec2 uv) {}
+            /// Builds the model matrix (translate * rotate XYZ * scale, rotation in degrees) and its normal matrix
+            static void compose(const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& size, glm::mat4& model, glm::mat3& normal) {
+                glm::mat4 translate = glm::translate(glm::mat4(1.f), position);
+                glm::mat4 rotate_x = glm::rotate(glm::mat4(1.f), glm::radians(rotation.x), glm::vec3(1.f, 0.f, 0.f));
+                glm::mat4 rotate_y = glm::rotate(glm::mat4(1.f), glm::radians(rotation.y), glm::vec3(0.f, 1.f, 0.f));
+                glm::mat4 rotate_z = glm::rotate(glm::mat4(1.f), glm::radians(rotation.z), glm::vec3(0.f, 0.f, 1.f));
+                glm::mat4 scale = glm::scale(glm::mat4(1.f), size);
+                glm::mat4 rotate = rotate_x * rotate_y * rotate_z;
+
+                model = translate * rotate * scale;
+
+                // transpose(inverse(R * S)) == R * inverse(S), so no general inverse is needed
+                normal = glm::mat3(rotate);
+                for (int i = 0; i < 3; ++i) {
+                    normal[i] = size[i] != 0.f ? normal[i] / size[i] : glm::vec3(0.f);
+                }
+            }
+
+            /// Sets the cull state for a mesh. GL_NONE disables culling
+            static void apply_cull_face(GLenum cull_face) {
+                if (cull_face == GL_NONE) {
+                    glDisable(GL_CULL_FACE);
+                    return;
+                }
+                glEnable(GL_CULL_FACE);
+                glCullFace(cull_face);
+                glFrontFace(GL_CCW);
+            }
+
+            const glm::mat4& get_model_matrix() const {
+                if (_matrices_dirty) update_matrices();
+                return _model_matrix;
+            }
+
+            /// Inverse transpose of the model matrix, for transforming normals
+            const glm::mat3& get_normal_matrix() const {
+                if (_matrices_dirty) update_matrices();
+                return _normal_matrix;
+            }
+
+            /// Bounds in model space. Used for culling instanced meshes, the default is the [-1, 1] cube
+            virtual AABB get_local_bounds() const {
+                return { glm::vec3(-1.f), glm::vec3(1.f) };
+            }
+
+            const AABB& get_world_bounds() const {
+                if (_matrices_dirty) update_matrices();
+                return _world_bounds;
+            }
+
+            virtual void set_uv(glm::vec2 uv) {
+                _uv = uv;
+                touch();
+            }
 
             virtual void set_position(glm::vec3 position) {
                 _position = position;
+                touch_transform();
             }
 
             virtual void set_size(glm::vec3 size) {
                 _size = size;
+                touch_transform();
             }
 
             virtual void set_rotation(glm::vec3 rotation) {
                 _rotation = rotation;
+                touch_transform();
             }
 
             virtual glm::vec3 get_position() { return _position; }
@@ -95,6 +216,26 @@ namespace Novo {
             virtual glm::vec2 get_uv() { return _uv; }
             virtual const Novo::MeshID get_id() const { return MeshID::MeshBase; }
 
+            virtual GLenum get_cull_face() const { return GL_FRONT; }
+
+            /// Whether the scene may draw this mesh as part of an instanced batch instead of calling draw()
+            virtual bool is_instanceable() const { return false; }
+
+            /// Makes touch() report `id` into `ids`, a mesh reports to one owner. The mesh is reported right away so the owner
+            /// picks up its current state, nullptr detaches it
+            void set_change_list(std::vector<uint32_t>* ids, uint32_t id) {
+                _changes.ids = ids;
+                _changes.id = id;
+                _changes.queued = false;
+                touch();
+            }
+
+            /// Called by the owner for every reported mesh it processed, the next change is reported again
+            void take_change() {
+                _changes.queued = false;
+            }
+
+            std::shared_ptr<Geometry> get_geometry() { return _geometry; }
             virtual std::shared_ptr<Shader> get_shader() { return _shader; }
             virtual std::shared_ptr<Texture2D> get_texture() { return _texture; }
             virtual std::shared_ptr<Material> get_material() { return _material; }
@@ -105,10 +246,12 @@ namespace Novo {
 
             virtual void show(bool draw = true) {
                 _draw = draw;
+                touch();
             }
             
             virtual void hide(bool draw = false) {
                 _draw = draw;
+                touch();
             }
 
             virtual bool is_visible() {
@@ -143,7 +286,9 @@ namespace Novo {
                     }
                     ImGui::TreePop();
                 }
-                ImGui::Checkbox("Show", &_draw);
+                if (ImGui::Checkbox("Show", &_draw)) {
+                    show(_draw);
+                }
             }
 
             virtual void reload() {
@@ -2,19 +2,6 @@
 
 #include <novo-core/Mesh/MeshBase.hpp>
 
-#define VERTIECES_NORMAL_UV { \
-/*  X   Y   Z     NORMAL              U    V*/      \
-    -1, 0, -1, 0.0, 1.0, 0.0,      _uv.x,   0.f,   \
-    1, 0, -1,  0.0, 1.0, 0.0,      0.f,     0.f,   \
-    1,  0, 1,  0.0, 1.0, 0.0,      0.f,     _uv.y, \
-    -1, 0, 1,  0.0, 1.0, 0.0,      _uv.x,   _uv.y, \
-\
-    -1, 0, 1,  0.0,-1.0, 0.0,      _uv.x,   _uv.y, \
-    1,  0, 1,  0.0,-1.0, 0.0,      0.f,     _uv.y, \
-    1, 0, -1,  0.0,-1.0, 0.0,      0.f,     0.f,   \
-    -1, 0, -1, 0.0,-1.0, 0.0,      _uv.x,   0.f,   \
-}
-
 namespace Novo {
     namespace Mesh {
         class Plane : public MeshBase {
@@ -23,9 +10,25 @@ namespace Novo {
         public:
             Plane(std::shared_ptr<Novo::Texture2D> texture, std::shared_ptr<Novo::Shader> shader, std::shared_ptr<Material> material, glm::vec3 position = glm::vec3(0), glm::vec3 size = glm::vec3(1), glm::vec3 rotation = glm::vec3(0))
             : MeshBase(std::move(texture), std::move(shader), std::move(material), position, size, rotation) {
-                GLfloat vertices_uv[] = VERTIECES_NORMAL_UV;
+                _geometry = get_geometry(false);
+            }
+
+            /// Shared quad. UVs are in [0, 1] and scaled per mesh by the `uv_scale` uniform
+            static std::shared_ptr<Novo::Geometry> get_geometry(bool one_side) {
+                static const GLfloat vertices_uv[] = {
+                /*  X   Y   Z     NORMAL           U      V  */
+                    -1, 0, -1, 0.0, 1.0, 0.0,      1.f,   0.f,
+                    1, 0, -1,  0.0, 1.0, 0.0,      0.f,   0.f,
+                    1,  0, 1,  0.0, 1.0, 0.0,      0.f,   1.f,
+                    -1, 0, 1,  0.0, 1.0, 0.0,      1.f,   1.f,
+
+                    -1, 0, 1,  0.0,-1.0, 0.0,      1.f,   1.f,
+                    1,  0, 1,  0.0,-1.0, 0.0,      0.f,   1.f,
+                    1, 0, -1,  0.0,-1.0, 0.0,      0.f,   0.f,
+                    -1, 0, -1, 0.0,-1.0, 0.0,      1.f,   0.f,
+                };
 
-                GLuint indices[] = {
+                static const GLuint indices[] = {
                     0, 1, 2,
                     0, 2, 3,
 
@@ -33,35 +36,20 @@ namespace Novo {
                     4, 6, 7,
                 };
 
-                _vbo = new Novo::VBO(vertices_uv, sizeof(vertices_uv), Novo::Layout::l_texture);
-                _ibo = new Novo::IBO(indices, sizeof(indices) / sizeof(GLuint));
-                _vao = new Novo::VAO();
-                
-                _vao->addVBO(*_vbo);
-                _vao->setIBO(*_ibo);
+                if (one_side) {
+                    return Novo::GeometryRegistry::get(Novo::GeometryID::PlaneOneSided, [] {
+                        return std::make_shared<Novo::Geometry>(vertices_uv, sizeof(vertices_uv), Novo::Layout::l_texture, indices, 6);
+                    });
+                }
+
+                return Novo::GeometryRegistry::get(Novo::GeometryID::Plane, [] {
+                    return std::make_shared<Novo::Geometry>(vertices_uv, sizeof(vertices_uv), Novo::Layout::l_texture, indices, sizeof(indices) / sizeof(GLuint));
+                });
             }
 
             void change_side_mode() {
-                if (_one_side) {
-                    delete _ibo;
-                    GLuint indices[] = {
-                        0, 1, 2,
-                        0, 2, 3,
-                    };
-
-                    _ibo = new Novo::IBO(indices, sizeof(indices) / sizeof(GLuint));
-                } else {
-                    delete _ibo;
-                    GLuint indices[] = {
-                        0, 1, 2,
-                        0, 2, 3,
-
-                        4, 5, 6,
-                        4, 6, 7,
-                    };
-
-                    _ibo = new Novo::IBO(indices, sizeof(indices) / sizeof(GLuint));
-                }
+                _geometry = get_geometry(_one_side);
+                touch();
             }
 
             virtual void draw_ui(const std::string& tab_name) override {
@@ -71,23 +59,9 @@ namespace Novo {
                 }
             }
 
+            virtual AABB get_local_bounds() const override { return { glm::vec3(-1.f, 0.f, -1.f), glm::vec3(1.f, 0.f, 1.f) }; }
+            virtual bool is_instanceable() const override { return true; }
             virtual const Novo::MeshID get_id() const { return MeshID::Plane; }
-
-            virtual void set_uv(glm::vec2 uv) override {
-                _uv = uv;
-                GLfloat new_uv[] = VERTIECES_NORMAL_UV;
-
-                delete _vbo;
-                delete _vao;
-
-                _vbo = new Novo::VBO(new_uv, sizeof(new_uv), Novo::Layout::l_texture);
-                _vao = new Novo::VAO();
-                
-                _vao->addVBO(*_vbo);
-                _vao->setIBO(*_ibo);
-            }
         };
     }
 }
-
-#undef VERTIECES_NORMAL_UV
\ No newline at end of file
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <novo-core/InstanceBatch.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Novo {
+    /// Draw items sorted by a packed state key so consecutive items share as much GL state as possible.
+    /// Key layout, most significant first: shader (16 bits), texture (16), cull face (2), geometry (14), material (16).
+    /// Material is last because the indirect path fetches it per draw, so only the bits above it split multi-draw calls
+    class RenderQueue {
+    public:
+        struct Item {
+            uint64_t key;
+            InstanceBatch* batch;
+        };
+    private:
+        std::vector<Item> _items;
+        std::unordered_map<const void*, uint16_t> _ids; // Small sort ids for shader/texture/material pointers
+
+        uint16_t id_of(const void* pointer) {
+            auto it = _ids.find(pointer);
+            if (it != _ids.end()) return it->second;
+            // Ids only group items, a wrap-around after 65536 resources costs some state changes but stays correct
+            uint16_t id = static_cast<uint16_t>(_ids.size());
+            _ids.emplace(pointer, id);
+            return id;
+        }
+
+        static uint64_t cull_bits(GLenum cull_face) {
+            switch (cull_face) {
+                case GL_NONE: return 0;
+                case GL_BACK: return 1;
+                case GL_FRONT: return 2;
+                default: return 3;
+            }
+        }
+    public:
+        /// Also forgets the sort ids, so pointers of freed resources don't pile up across batch rebuilds
+        void clear() {
+            _items.clear();
+            _ids.clear();
+        }
+
+        void add(InstanceBatch& batch) {
+            const InstanceBatch::Key key = batch.get_key();
+            const uint64_t packed =
+                (static_cast<uint64_t>(id_of(key.shader)) << 48) |
+                (static_cast<uint64_t>(id_of(key.texture)) << 32) |
+                (cull_bits(key.cull_face) << 30) |
+                (static_cast<uint64_t>(id_of(key.geometry) & 0x3FFF) << 16) |
+                static_cast<uint64_t>(id_of(key.material));
+            _items.push_back({packed, &batch});
+        }
+
+        void sort() {
+            std::sort(_items.begin(), _items.end(), [](const Item& a, const Item& b) {
+                return a.key < b.key;
+            });
+        }
+
+        const std::vector<Item>& get_items() const {
+            return _items;
+        }
+    };
+}
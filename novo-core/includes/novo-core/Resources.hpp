@@ -8,6 +8,8 @@
 #include <fstream>
 #include <sstream>
 #include <map>
+#include <cstring>
+#include <filesystem>
 
 #include "stb_image.h"
 #include "json.hpp"
@@ -15,6 +17,9 @@
 #include <novo-core/Texture2D.hpp>
 #include <novo-core/Shader.hpp>
 #include <novo-core/Material.hpp>
+#include <novo-core/JobSystem.hpp>
+#include <novo-core/StagingRing.hpp>
+#include <novo-core/DDS.hpp>
 
 namespace Novo {
     using Byte = char;
@@ -31,6 +36,7 @@ namespace Novo {
         using ShaderPaths = std::map<std::string, FragVertPaths>;  // first - name, second - paths
         using MaterialsPaths = std::map<std::string, std::string>; // first - name, second - path
         using TexturesPaths = std::map<std::string, std::string>;  // first - name, second - path
+        using TexturesCompression = std::map<std::string, std::string>; // first - name, second - novo-texcook format
 
         std::string _exePath;
         TexturesMap _texturesMap;
@@ -40,10 +46,54 @@ namespace Novo {
         ShaderPaths _shaderPaths;
         MaterialsPaths _materialsPaths;
         TexturesPaths _texturesPaths;
+        TexturesCompression _texturesCompression;
+
+        std::shared_ptr<JobSystem> _jobs;
+        JobSystem::CounterPtr _textureJobs;
+
+        std::shared_ptr<StagingRing> _staging;
+        std::shared_ptr<StagingRing> _textureStaging;
+        static constexpr size_t STAGING_SIZE = 16 * 1024 * 1024;
+        static constexpr size_t TEXTURE_STAGING_SIZE = 64 * 1024 * 1024;
+
+        /// Decodes the image at `fullPath` with stb_image and queues its upload into `texture`. Worker thread only
+        static void streamImage(const std::shared_ptr<JobSystem>& jobs, const JobSystem::CounterPtr& counter,
+            const std::shared_ptr<StagingRing>& staging, const std::shared_ptr<Texture2D>& texture, const std::string& fullPath) {
+            int width, height, channels;
+            stbi_set_flip_vertically_on_load_thread(true);
+            std::shared_ptr<unsigned char> image(stbi_load(fullPath.c_str(), &width, &height, &channels, 0), stbi_image_free);
+
+            if (!image) {
+                std::cerr << "Failed to load texture " << fullPath << std::endl;
+                return;
+            }
+
+            // Copy into the staging ring here, so the GL thread only issues the upload
+            const StagingRing::Allocation region = staging->allocate(size_t(width) * height * channels);
+            if (region) {
+                std::memcpy(region.data, image.get(), region.size);
+                jobs->submit_main([staging, region, texture, width, height, channels] {
+                    texture->upload(staging->getID(), region.offset, glm::vec2(width, height), channels);
+                    staging->fence(region);
+                    staging->retire();
+                }, counter);
+                return;
+            }
+
+            jobs->submit_main([texture, image, width, height, channels] {
+                texture->upload(image.get(), glm::vec2(width, height), channels);
+            }, counter);
+        }
     public:
-        Resources(const std::string& exePath) {
+        /// @param jobs worker pool for loadTextureAsync(), textures load synchronously without one
+        Resources(const std::string& exePath, std::shared_ptr<JobSystem> jobs = nullptr) {
             size_t found = exePath.find_last_of("/\\");
             _exePath = exePath.substr(0, found + 1);
+
+            _jobs = jobs;
+            if (_jobs) {
+                _textureJobs = _jobs->make_counter();
+            }
         }
 
         std::string getFileStr(const std::string& path) {
@@ -60,7 +110,27 @@ namespace Novo {
             return buffer.str();
         };
 
+        /// Path of the texture novo-texcook built from `path` (same name with a .dds extension) if there is one, `path` otherwise
+        std::string getCookedTexturePath(const std::string& path) {
+            std::filesystem::path cooked(path);
+            if (cooked.extension() == ".dds") return path;
+
+            cooked.replace_extension(".dds");
+            std::error_code error;
+            return std::filesystem::exists(_exePath + "/" + cooked.string(), error) ? cooked.string() : path;
+        }
+
         std::shared_ptr<Texture2D> loadTexture(const std::string& name, const std::string& path) {
+            const std::string cooked = getCookedTexturePath(path);
+            if (std::filesystem::path(cooked).extension() == ".dds") {
+                CompressedImage image;
+                if (DDS::read(_exePath + "/" + cooked, image)) {
+                    _texturesMap[name] = std::make_shared<Texture2D>(image);
+                    _texturesPaths[name] = path;
+                    return _texturesMap[name];
+                }
+            }
+
             int width, height, channels;
             stbi_set_flip_vertically_on_load(true);
             Image image = stbi_load((_exePath + "/" + path).c_str(), &width, &height, &channels, 0);
@@ -77,6 +147,84 @@ namespace Novo {
             return _texturesMap[name];
         }
 
+        /// Returns a 1x1 placeholder right away and decodes the image on a worker thread.
+        /// The placeholder gets the real pixels from a main thread job, so uploads are spread over frames by JobSystem::run_main_jobs()
+        std::shared_ptr<Texture2D> loadTextureAsync(const std::string& name, const std::string& path) {
+            if (!_jobs) {
+                return loadTexture(name, path);
+            }
+
+            static const unsigned char placeholder[] = { 128, 128, 128, 255 };
+            auto texture = std::make_shared<Texture2D>(placeholder, glm::vec2(1, 1), 4);
+            _texturesMap[name] = texture;
+            _texturesPaths[name] = path;
+
+            const std::string fullPath = _exePath + "/" + path;
+            std::shared_ptr<JobSystem> jobs = _jobs;
+            JobSystem::CounterPtr counter = _textureJobs;
+            std::shared_ptr<StagingRing> staging = getTextureStagingRing();
+
+            const std::string cooked = getCookedTexturePath(path);
+            if (std::filesystem::path(cooked).extension() == ".dds") {
+                const std::string cookedPath = _exePath + "/" + cooked;
+                _jobs->submit([jobs, counter, staging, texture, cookedPath, fullPath] {
+                    auto image = std::make_shared<CompressedImage>();
+                    if (!DDS::read(cookedPath, *image)) {
+                        streamImage(jobs, counter, staging, texture, fullPath);
+                        return;
+                    }
+
+                    const StagingRing::Allocation region = staging->allocate(image->data.size());
+                    if (region) {
+                        std::memcpy(region.data, image->data.data(), region.size);
+                        image->data.clear();
+                        image->data.shrink_to_fit();
+                        jobs->submit_main([staging, region, texture, image] {
+                            texture->upload(*image, staging->getID(), region.offset);
+                            staging->fence(region);
+                            staging->retire();
+                        }, counter);
+                        return;
+                    }
+
+                    jobs->submit_main([texture, image] {
+                        texture->upload(*image);
+                    }, counter);
+                }, _textureJobs);
+                return texture;
+            }
+
+            _jobs->submit([jobs, counter, staging, texture, fullPath] {
+                streamImage(jobs, counter, staging, texture, fullPath);
+            }, _textureJobs);
+
+            return texture;
+        }
+
+        /// Upload buffer for per-frame data like instances, created on first use. GL thread only
+        std::shared_ptr<StagingRing> getStagingRing() {
+            if (!_staging) {
+                _staging = std::make_shared<StagingRing>(STAGING_SIZE);
+            }
+            return _staging;
+        }
+
+        /// Upload buffer of texture streaming. Worker regions wait for their main thread job before they are fenced,
+        /// on a ring of their own they don't hold back the per-frame regions. GL thread only
+        std::shared_ptr<StagingRing> getTextureStagingRing() {
+            if (!_textureStaging) {
+                _textureStaging = std::make_shared<StagingRing>(TEXTURE_STAGING_SIZE);
+            }
+            return _textureStaging;
+        }
+
+        /// Blocks until every loadTextureAsync() image is decoded and uploaded. Must be called from the main thread
+        void waitForTextures() {
+            if (_jobs) {
+                _jobs->wait(_textureJobs);
+            }
+        }
+
         std::shared_ptr<Texture2D> getTexture(const std::string& name) {
             if (_texturesMap.find(name) != _texturesMap.end()) {
                 return _texturesMap[name];
@@ -147,6 +295,18 @@ namespace Novo {
             }
         }
 
+        bool hasShader(const std::string& name) const {
+            return _shadersMap.find(name) != _shadersMap.end();
+        }
+
+        bool hasMaterial(const std::string& name) const {
+            return _materialsMap.find(name) != _materialsMap.end();
+        }
+
+        bool hasTexture(const std::string& name) const {
+            return _texturesMap.find(name) != _texturesMap.end();
+        }
+
         std::string getShaderName(const std::shared_ptr<Shader>& shader) {
             for (auto& shader_ref : _shadersMap) {
                 if (shader_ref.second == shader) {
@@ -174,30 +334,43 @@ namespace Novo {
             return "None";
         }
 
-        TexturesMap getTexturesMap() {
+        const TexturesMap& getTexturesMap() const {
             return _texturesMap;
         }
 
-        ShadersMap getShadersMap() {
+        const ShadersMap& getShadersMap() const {
             return _shadersMap;
         }
 
-        MaterialsMap getMaterialsMap() {
+        const MaterialsMap& getMaterialsMap() const {
             return _materialsMap;
         }
 
-        ShaderPaths getShaderPaths() {
+        const ShaderPaths& getShaderPaths() const {
             return _shaderPaths;
         }
 
-        TexturesPaths getTexturesPaths() {
+        const TexturesPaths& getTexturesPaths() const {
             return _texturesPaths;
         }
 
-        MaterialsPaths getMaterialsPaths() {
+        const MaterialsPaths& getMaterialsPaths() const {
             return _materialsPaths;
         }
 
+        /// Cook setting of a texture, only kept so saving a scene writes it back. Empty lets novo-texcook choose
+        void setTextureCompression(const std::string& name, const std::string& compression) {
+            if (compression.empty()) {
+                _texturesCompression.erase(name);
+            } else {
+                _texturesCompression[name] = compression;
+            }
+        }
+
+        const TexturesCompression& getTexturesCompression() const {
+            return _texturesCompression;
+        }
+
         std::string getExePath() {
             return _exePath;
         }
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <novo-core/VBO.hpp>
+
+namespace Novo {
+    class SSBO {
+    private:
+        GLuint _id;
+        GLuint _binding;
+        size_t _size = 0;
+        VBO::Mode _mode;
+    public:
+        SSBO(const GLuint binding, const size_t size = 0, const VBO::Mode mode = VBO::Mode::DYNAMIC)
+            : _binding(binding), _mode(mode) {
+            glCreateBuffers(1, &_id);
+            reserve(size);
+        }
+
+        ~SSBO() {
+            glDeleteBuffers(1, &_id);
+        }
+
+        SSBO(const SSBO&) = delete;
+        SSBO& operator=(const SSBO&) = delete;
+
+        /// Grows the storage to at least `size` bytes. Old contents are discarded on growth.
+        void reserve(const size_t size) {
+            if (size <= _size && _size != 0) return;
+            _size = size;
+            glNamedBufferData(_id, _size, nullptr, VBO::modeToGL(_mode));
+        }
+
+        void set_data(const void* data, const size_t size, const size_t offset = 0) {
+            if (size == 0) return;
+            glNamedBufferSubData(_id, offset, size, data);
+        }
+
+        void bind() const {
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, _binding, _id);
+        }
+
+        static void unbind(const GLuint binding) {
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, 0);
+        }
+
+        size_t get_size() const {
+            return _size;
+        }
+
+        GLuint get_binding() const {
+            return _binding;
+        }
+    };
+}
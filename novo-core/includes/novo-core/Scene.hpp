@@ -4,282 +4,715 @@
 #include <novo-core/Mesh/Box.hpp>
 #include <novo-core/Mesh/Plane.hpp>
 #include <novo-core/Mesh/LightSource.hpp>
+#include <novo-core/LightBuffer.hpp>
+#include <novo-core/ClusterGrid.hpp>
+#include <novo-core/InstanceBatch.hpp>
+#include <novo-core/IndirectRenderer.hpp>
+#include <novo-core/LightGizmos.hpp>
+#include <novo-core/RenderQueue.hpp>
+#include <novo-core/StateCache.hpp>
+#include <novo-core/BVH.hpp>
+#include <novo-core/ECS/Registry.hpp>
+#include <novo-core/ECS/Components.hpp>
+#include <novo-core/ECS/Systems.hpp>
+#include <novo-core/JobSystem.hpp>
+#include <novo-core/SceneFile.hpp>
+#include <novo-core/SceneJson.hpp>
+#include <novo-core/MappedFile.hpp>
+#include <novo-core/JsonWriter.hpp>
+#include <unordered_map>
 #include <vector>
 
 namespace Novo {
     class Scene {
     private:
-        using ObjPair = std::pair<std::shared_ptr<Novo::Mesh::MeshBase>, std::string>;
-        using LightPair = std::pair<std::shared_ptr<Novo::Mesh::LightSource>, std::string>;
-        std::map<int, ObjPair> _objects  = {}; // first - id, second - ObjPair
-        std::map<int, LightPair> _lights = {}; // first - id, second - LightPair
+        Novo::ECS::Registry _registry;
         std::shared_ptr<Novo::Resources> _resources;
+        std::shared_ptr<Novo::JobSystem> _jobs;
         std::string _name = "Scene";
         int _lastID = 0;
+
+        Novo::LightBuffer _light_buffer;
+        Novo::ClusterGrid _cluster_grid;
+        glm::vec2 _viewport_size = glm::vec2(1.f);
+
+        std::map<InstanceBatch::Key, InstanceBatch> _batches;
+        std::vector<Novo::Mesh::MeshBase*> _unbatched;
+        bool _batches_dirty = true;
+
+        Novo::RenderQueue _queue;
+        Novo::StateCache _state;
+        std::unique_ptr<Novo::IndirectRenderer> _indirect = nullptr; // Null when the context can't multi-draw, batches are drawn one by one
+        size_t _drawn_count = 0;
+        size_t _culled_count = 0;
+
+        Novo::LightGizmos _gizmos;
+        bool _draw_gizmos = true;
+
+        /// Where culling results for an object go. Both null for hidden objects
+        struct DrawSlot {
+            InstanceBatch* batch = nullptr;
+            size_t index = 0;
+            Novo::Mesh::MeshBase* mesh = nullptr; // Unbatched mesh
+        };
+
+        Novo::BVH _bvh;
+        std::vector<DrawSlot> _slots; // Indexed by Entity::index
+        std::vector<Novo::ECS::Entity> _visible_unbatched;
+
+        std::vector<uint32_t> _changes; // Entity indices reported by edited meshes and lights, see MeshBase::set_change_list()
+        std::vector<Novo::ECS::Entity> _synced;
+        std::vector<Novo::ECS::Entity> _moved;
+        std::vector<Novo::ECS::Entity> _visible;
+
+        static bool can_batch(Novo::Mesh::MeshBase& mesh) {
+            return mesh.is_instanceable() && mesh.get_geometry() && mesh.get_shader() && mesh.get_texture() && mesh.get_material();
+        }
+
+        void rebuild_batches() {
+            _batches.clear();
+            _unbatched.clear();
+            _slots.assign(_registry.get_capacity(), DrawSlot());
+
+            _registry.each<Novo::ECS::MeshRenderer, Novo::ECS::Transform>([&](Novo::ECS::Entity entity, Novo::ECS::MeshRenderer& renderer, Novo::ECS::Transform& transform) {
+                Novo::Mesh::MeshBase& mesh = *renderer.mesh;
+                DrawSlot& slot = _slots[entity.index];
+                if (!can_batch(mesh)) {
+                    _unbatched.push_back(&mesh);
+                    slot.mesh = &mesh;
+                } else if (mesh.is_visible()) {
+                    InstanceBatch& batch = _batches.try_emplace(InstanceBatch::make_key(mesh), mesh).first->second;
+                    slot.batch = &batch;
+                    slot.index = batch.add(mesh, transform.world, transform.normal);
+                }
+            });
+
+            _queue.clear();
+            for (auto& batch : _batches) {
+                _queue.add(batch.second);
+            }
+            _queue.sort();
+            if (_indirect) _indirect->invalidate();
+
+            _batches_dirty = false;
+        }
+
+        /// Carries UV edits of synced meshes into their batch, a change of visibility or batch key needs a rebuild
+        void refresh_batches(const std::vector<Novo::ECS::Entity>& synced) {
+            for (const Novo::ECS::Entity entity : synced) {
+                const Novo::ECS::MeshRenderer* renderer = _registry.try_get<Novo::ECS::MeshRenderer>(entity);
+                if (!renderer) continue;
+
+                Novo::Mesh::MeshBase& mesh = *renderer->mesh;
+                const DrawSlot& slot = _slots[entity.index];
+                if (slot.mesh) continue; // Unbatched meshes are drawn from their own state
+                if (!slot.batch) {
+                    // Hidden by the last rebuild
+                    if (mesh.is_visible()) {
+                        _batches_dirty = true;
+                        return;
+                    }
+                    continue;
+                }
+                if (!mesh.is_visible() || !(InstanceBatch::make_key(mesh) == slot.batch->get_key())) {
+                    _batches_dirty = true;
+                    return;
+                }
+                slot.batch->set_uv(slot.index, mesh.get_uv());
+            }
+        }
+
+        /// Runs the systems that bring components, world matrices and the BVH up to date, then passes the changes on to the batches
+        void update_entities() {
+            _synced.clear();
+            Novo::ECS::sync_changes(_registry, _changes, _synced);
+
+            _moved.clear();
+            Novo::ECS::update_transforms(_registry, _moved, _jobs.get());
+            Novo::ECS::update_bvh(_registry, _bvh, _moved);
+
+            // A pending rebuild reads every mesh and transform anyway
+            if (!_batches_dirty) refresh_batches(_synced);
+            if (_batches_dirty) return;
+            for (const Novo::ECS::Entity entity : _moved) {
+                if (entity.index >= _slots.size() || !_slots[entity.index].batch) continue; // Lights have no slot
+                const Novo::ECS::Transform& transform = _registry.get<Novo::ECS::Transform>(entity);
+                _slots[entity.index].batch->set_transform(_slots[entity.index].index, transform.world, transform.normal);
+            }
+        }
+
+        /// Stops the meshes from reporting into _changes, they may outlive the scene or its entities
+        void detach_meshes() {
+            _registry.each<Novo::ECS::MeshRenderer>([](Novo::ECS::Entity, Novo::ECS::MeshRenderer& renderer) {
+                renderer.mesh->set_change_list(nullptr, 0);
+            });
+            _registry.each<Novo::ECS::Light>([](Novo::ECS::Entity, Novo::ECS::Light& light) {
+                light.source->set_change_list(nullptr, 0);
+            });
+        }
+
+        /// Routes the visible entities to their instance batches, or to the unbatched list
+        void submit(const std::vector<Novo::ECS::Entity>& visible) {
+            for (auto& batch : _batches) {
+                batch.second.begin_cull();
+            }
+            _visible_unbatched.clear();
+
+            for (const Novo::ECS::Entity entity : visible) {
+                const DrawSlot& slot = _slots[entity.index];
+                if (slot.batch) {
+                    slot.batch->mark_visible(slot.index);
+                } else if (slot.mesh) {
+                    _visible_unbatched.push_back(entity);
+                }
+            }
+        }
+
+        /// Pointer to name lookups over the loaded resources, built once per save so every object is O(1)
+        struct ResourceNames {
+            std::unordered_map<const void*, const std::string*> shaders;
+            std::unordered_map<const void*, const std::string*> materials;
+            std::unordered_map<const void*, const std::string*> textures;
+
+            explicit ResourceNames(const Novo::Resources& resources) {
+                for (auto& shader : resources.getShadersMap()) shaders.emplace(shader.second.get(), &shader.first);
+                for (auto& material : resources.getMaterialsMap()) materials.emplace(material.second.get(), &material.first);
+                for (auto& texture : resources.getTexturesMap()) textures.emplace(texture.second.get(), &texture.first);
+            }
+
+            /// Same fallback as Resources::getShaderName()
+            static const std::string& find(const std::unordered_map<const void*, const std::string*>& names, const void* resource) {
+                static const std::string none = "None";
+                auto found = names.find(resource);
+                return found == names.end() ? none : *found->second;
+            }
+
+            const std::string& shader(const std::shared_ptr<Shader>& value) const { return find(shaders, value.get()); }
+            const std::string& material(const std::shared_ptr<Material>& value) const { return find(materials, value.get()); }
+            const std::string& texture(const std::shared_ptr<Texture2D>& value) const { return find(textures, value.get()); }
+        };
+
+        template <typename Map>
+        static const typename Map::mapped_type& find_or_empty(const Map& map, const std::string& key) {
+            static const typename Map::mapped_type empty{};
+            auto found = map.find(key);
+            return found == map.end() ? empty : found->second;
+        }
+
+        /// Writes the parts every object has, the caller closes the object
+        static void write_object(Novo::JsonWriter& writer, const std::string& name, Novo::MeshID type, const std::string& shader, const std::string& material,
+                                 const std::string& texture, const glm::vec2& uv, const Novo::ECS::Transform& transform) {
+            writer.begin_object();
+            writer.key("name").value(name);
+            writer.key("type.id").value(static_cast<int>(type));
+            writer.key("shader").value(shader);
+            writer.key("material").value(material);
+            writer.key("texture").value(texture);
+            writer.key("uv.x").value(uv.x);
+            writer.key("uv.y").value(uv.y);
+            writer.key("transform").begin_object();
+            writer.key("position").vec3(transform.position);
+            writer.key("rotation").vec3(transform.rotation);
+            writer.key("scale").vec3(transform.scale);
+            writer.end_object();
+        }
+
+        /// Creates a loaded object or light. Resources the type doesn't need may be null
+        void spawn(Novo::MeshID type, const std::string& name, const std::shared_ptr<Shader>& shader, const std::shared_ptr<Material>& material, const std::shared_ptr<Texture2D>& texture,
+                   const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale, const glm::vec2& uv, const glm::vec3& color, float radius) {
+            if (type == Novo::MeshID::Box) {
+                auto p_obj = std::make_shared<Novo::Mesh::Box>(texture, shader, material, position, scale, rotation);
+                p_obj->set_uv(uv);
+                add_object(p_obj, name);
+            } else if (type == Novo::MeshID::Plane) {
+                auto p_obj = std::make_shared<Novo::Mesh::Plane>(texture, shader, material, position, scale, rotation);
+                p_obj->set_uv(uv);
+                add_object(p_obj, name);
+            } else if (type == Novo::MeshID::Light) {
+                auto p_light = std::make_shared<Novo::Mesh::LightSource>(color, shader, position, scale, rotation);
+                p_light->set_radius(radius);
+                add_light(p_light, name);
+            }
+        }
+
+        /// Resolves the resource names of a loaded object, missing ones are reported by Resources
+        void spawn(const Novo::SceneFile::Object& object) {
+            const bool textured = object.type != Novo::MeshID::Light;
+            spawn(object.type, object.name, _resources->getShader(object.shader),
+                  textured ? _resources->getMaterial(object.material) : nullptr,
+                  textured ? _resources->getTexture(object.texture) : nullptr,
+                  object.position, object.rotation, object.scale, object.uv, object.color, object.radius);
+        }
+
+        /// Feeds SceneJson::read() into the scene. Objects parsed before their resources wait in `pending`
+        struct JsonLoader : Novo::SceneJson::Handler {
+            Scene& scene;
+            std::vector<Novo::SceneFile::Object> pending;
+
+            explicit JsonLoader(Scene& target) : scene(target) {}
+
+            void on_name(const std::string& name) override {
+                scene._name = name;
+            }
+
+            void on_shader(const std::string& name, const std::string& vertex, const std::string& fragment) override {
+                scene._resources->loadShader(name, vertex, fragment);
+            }
+
+            void on_material(const std::string& name, const std::string& path) override {
+                scene._resources->loadMaterial(name, path);
+            }
+
+            void on_texture(const std::string& name, const std::string& path, const std::string& compression) override {
+                scene._resources->loadTextureAsync(name, path);
+                scene._resources->setTextureCompression(name, compression);
+            }
+
+            void on_object(Novo::SceneFile::Object& object) override {
+                Novo::Resources& resources = *scene._resources;
+                const bool ready = resources.hasShader(object.shader)
+                    && (object.type == Novo::MeshID::Light || (resources.hasMaterial(object.material) && resources.hasTexture(object.texture)));
+                if (ready) {
+                    scene.spawn(object);
+                } else {
+                    pending.push_back(std::move(object));
+                }
+            }
+        };
+
+        /// Light cubes in their own pass, all lights with the same shader in one instanced draw
+        void draw_gizmos() {
+            _gizmos.clear();
+            if (!_draw_gizmos) return;
+
+            _registry.each<Novo::ECS::Light, Novo::ECS::Transform>([&](Novo::ECS::Entity entity, Novo::ECS::Light& light, Novo::ECS::Transform& transform) {
+                if (!light.active || _registry.has<Novo::ECS::Hidden>(entity)) return;
+                Novo::Shader* shader = light.source->get_shader().get();
+                if (shader) _gizmos.add(*shader, transform.world, light.color);
+            });
+            _gizmos.draw(_state);
+        }
     public:
-        Scene(std::shared_ptr<Novo::Resources> resources) {
+        /// @param jobs worker pool for the per-frame transform and culling systems, they run serially without one
+        Scene(std::shared_ptr<Novo::Resources> resources, std::shared_ptr<Novo::JobSystem> jobs = nullptr) {
             _resources = resources;
+            _jobs = jobs;
+            if (Novo::IndirectRenderer::is_supported()) {
+                _indirect = std::make_unique<Novo::IndirectRenderer>();
+            }
         }
 
+        ~Scene() {
+            detach_meshes();
+        }
+
+        /// Streams the scene from the mapped file, objects are created while parsing and no JSON DOM is built
         Scene& load_from_json(const std::string& path) {
-            Json json = Json::parse(_resources->getFileStr(path));
+            Novo::MappedFile file(_resources->getExePath() + path);
+            if (!file.is_open()) return *this;
 
-            _name = json["name"];
-            
-            std::vector<Json> shaders = json["shaders"];
-            for (auto& shader : shaders) {
-                _resources->loadShader(shader["name"], shader["vs"], shader["fs"]);
+            JsonLoader loader(*this);
+            std::string error;
+            const char* text = reinterpret_cast<const char*>(file.get_data());
+            if (!Novo::SceneJson::read(text, text + file.get_size(), loader, error)) {
+                std::cerr << "Failed to parse scene " << path << ": " << error << std::endl;
             }
 
-            std::vector<Json> materials = json["materials"];
-            for (auto& material : materials) {
-                _resources->loadMaterial(material["name"], material["path"]);
+            for (const auto& object : loader.pending) {
+                spawn(object);
             }
+            return *this;
+        }
 
-            std::vector<Json> textures = json["textures"];
-            for (auto& texture : textures) {
-                _resources->loadTexture(texture["name"], texture["path"]);
+        /// Loads a scene written by save_to_binary() or novo-sceneconv. The file is memory mapped and read in place,
+        /// resources are resolved once per table entry and objects refer to them by index
+        Scene& load_from_binary(const std::string& path) {
+            Novo::MappedFile file(_resources->getExePath() + path);
+            if (!file.is_open()) return *this;
+
+            const Novo::SceneFile::View view(file.get_data(), file.get_size());
+            if (!view.is_valid()) {
+                std::cerr << "Invalid or unsupported scene file " << path << std::endl;
+                return *this;
             }
 
-            std::vector<Json> objects = json["objects"];
-            for (auto& obj : objects) {
-                auto shader = _resources->getShader(obj["shader"]);
+            auto str = [&](const Novo::SceneFile::StringRef& ref) { return std::string(view.get_string(ref)); };
+            _name = str(view.get_header().name);
 
-                glm::vec3 position = glm::vec3(obj["transform"]["position"]["x"], obj["transform"]["position"]["y"], obj["transform"]["position"]["z"]);
-                glm::vec3 rotation = glm::vec3(obj["transform"]["rotation"]["x"], obj["transform"]["rotation"]["y"], obj["transform"]["rotation"]["z"]);
-                glm::vec3 scale    = glm::vec3(obj["transform"]["scale"]   ["x"], obj["transform"]["scale"]   ["y"], obj["transform"]["scale"]   ["z"]);
-                glm::vec2 uv       = glm::vec2(obj["uv.x"], obj["uv.y"]);
-                if (obj["type.id"] == Novo::MeshID::Box) {
-                    auto material = _resources->getMaterial(obj["material"]);
-                    auto texture = _resources->getTexture(obj["texture"]);
-                    auto p_obj = std::make_shared<Novo::Mesh::Box>(texture, shader, material, position, scale, rotation);
-                    p_obj->set_uv(uv);
-                    add_object(p_obj, obj["name"]);
-                } else if (obj["type.id"] == Novo::MeshID::Plane) {
-                    auto material = _resources->getMaterial(obj["material"]);
-                    auto texture = _resources->getTexture(obj["texture"]);
-                    auto p_obj = std::make_shared<Novo::Mesh::Plane>(texture, shader, material, position, scale, rotation);
-                    p_obj->set_uv(uv);
-                    add_object(p_obj, obj["name"]);
-                } else if (obj["type.id"] == Novo::MeshID::Light) {
-                    Json properties = obj["other"]["Light"];
-                    glm::vec3 color = glm::vec3(properties["color"]["r"], properties["color"]["g"], properties["color"]["b"]);
+            std::vector<std::shared_ptr<Shader>> shaders;
+            for (const auto& shader : view.get_shaders()) {
+                shaders.push_back(_resources->loadShader(str(shader.name), str(shader.vertex), str(shader.fragment)));
+            }
 
-                    add_light(std::make_shared<Novo::Mesh::LightSource>(color, shader, position, scale, rotation), obj["name"]);
-                }
+            std::vector<std::shared_ptr<Material>> materials;
+            for (const auto& material : view.get_materials()) {
+                materials.push_back(_resources->loadMaterial(str(material.name), str(material.path)));
+            }
+
+            std::vector<std::shared_ptr<Texture2D>> textures;
+            for (const auto& texture : view.get_textures()) {
+                textures.push_back(_resources->loadTextureAsync(str(texture.name), str(texture.path)));
+                _resources->setTextureCompression(str(texture.name), str(texture.compression));
+            }
+
+            auto resolve = [](const auto& table, uint32_t index) {
+                return index < table.size() ? table[index] : nullptr;
+            };
+            for (const auto& obj : view.get_objects()) {
+                spawn(static_cast<Novo::MeshID>(obj.type), str(obj.name), resolve(shaders, obj.shader), resolve(materials, obj.material), resolve(textures, obj.texture),
+                      glm::vec3(obj.position[0], obj.position[1], obj.position[2]),
+                      glm::vec3(obj.rotation[0], obj.rotation[1], obj.rotation[2]),
+                      glm::vec3(obj.scale[0], obj.scale[1], obj.scale[2]),
+                      glm::vec2(obj.uv[0], obj.uv[1]),
+                      glm::vec3(obj.color[0], obj.color[1], obj.color[2]), obj.radius);
             }
 
             return *this;
         }
 
-        Json save_to_json(const std::string& path) {
-            Json json;
-            json["name"] = _name;
-            json["shaders"] = Json::array();
-            json["materials"] = Json::array();
-            json["textures"] = Json::array();
-            json["objects"] = Json::array();
+        /// Picks the loader by extension, .nvscene is the binary format
+        Scene& load(const std::string& path) {
+            if (std::filesystem::path(path).extension() == ".nvscene") return load_from_binary(path);
+            return load_from_json(path);
+        }
+
+        /// Streams the scene to a buffered file without building a JSON document.
+        /// Resources are written before objects, so load_from_json() can create every object while parsing
+        bool save_to_json(const std::string& path) {
+            std::vector<char> buffer(1 << 20);
+            std::ofstream file;
+            file.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+            file.open(path, std::ios::out | std::ios::trunc);
+            if (!file.is_open()) {
+                std::cerr << "Failed to open file " << path << std::endl;
+                return false;
+            }
+
+            const ResourceNames names(*_resources);
+            Novo::JsonWriter writer(file);
+            writer.begin_object();
+            writer.key("name").value(_name);
 
+            writer.newline().key("shaders").begin_array();
             for (auto& shader : _resources->getShadersMap()) {
-                Json shaderJson;
-                shaderJson["name"] = shader.first;
-                shaderJson["vs"] = _resources->getShaderPaths()[shader.first].first;
-                shaderJson["fs"] = _resources->getShaderPaths()[shader.first].second;
-                json["shaders"].push_back(shaderJson);
+                const auto& paths = find_or_empty(_resources->getShaderPaths(), shader.first);
+                writer.newline().begin_object();
+                writer.key("name").value(shader.first);
+                writer.key("vs").value(paths.first);
+                writer.key("fs").value(paths.second);
+                writer.end_object();
             }
+            writer.end_array();
 
+            writer.newline().key("materials").begin_array();
             for (auto& material : _resources->getMaterialsMap()) {
-                Json materialJson;
-                materialJson["name"] = material.first;
-                materialJson["path"] = _resources->getMaterialsPaths()[material.first];
-                json["materials"].push_back(materialJson);
+                writer.newline().begin_object();
+                writer.key("name").value(material.first);
+                writer.key("path").value(find_or_empty(_resources->getMaterialsPaths(), material.first));
+                writer.end_object();
             }
+            writer.end_array();
+
+            writer.newline().key("textures").begin_array();
+            for (auto& texture : _resources->getTexturesMap()) {
+                writer.newline().begin_object();
+                writer.key("name").value(texture.first);
+                writer.key("path").value(find_or_empty(_resources->getTexturesPaths(), texture.first));
+                const std::string& compression = find_or_empty(_resources->getTexturesCompression(), texture.first);
+                if (!compression.empty()) writer.key("compression").value(compression);
+                writer.end_object();
+            }
+            writer.end_array();
+
+            update_entities();
+            writer.newline().key("objects").begin_array();
+            _registry.each<Novo::ECS::MeshRenderer, Novo::ECS::Transform, Novo::ECS::Name>([&](Novo::ECS::Entity, Novo::ECS::MeshRenderer& renderer, Novo::ECS::Transform& transform, Novo::ECS::Name& name) {
+                Novo::Mesh::MeshBase& mesh = *renderer.mesh;
 
+                writer.newline();
+                write_object(writer, name.value, mesh.get_id(), names.shader(mesh.get_shader()), names.material(mesh.get_material()), names.texture(mesh.get_texture()), mesh.get_uv(), transform);
+                writer.key("other").begin_object().end_object();
+                writer.end_object();
+            });
+
+            _registry.each<Novo::ECS::Light, Novo::ECS::Transform, Novo::ECS::Name>([&](Novo::ECS::Entity, Novo::ECS::Light& light, Novo::ECS::Transform& transform, Novo::ECS::Name& name) {
+                Novo::Mesh::LightSource& source = *light.source;
+
+                writer.newline();
+                write_object(writer, name.value, source.get_id(), names.shader(source.get_shader()), names.material(source.get_material()), names.texture(source.get_texture()), source.get_uv(), transform);
+                writer.key("other").begin_object();
+                writer.key("Light").begin_object();
+                writer.key("color").vec3(light.color, "r", "g", "b");
+                writer.key("radius").value(light.radius);
+                writer.end_object();
+                writer.end_object();
+                writer.end_object();
+            });
+            writer.newline().end_array();
+            writer.end_object().newline();
+
+            file.flush();
+            return static_cast<bool>(file);
+        }
+
+        bool save_to_binary(const std::string& path) {
+            Novo::SceneFile::Writer writer;
+            writer.set_name(_name);
+
+            for (auto& shader : _resources->getShadersMap()) {
+                const auto& paths = find_or_empty(_resources->getShaderPaths(), shader.first);
+                writer.add_shader(shader.first, paths.first, paths.second);
+            }
+            for (auto& material : _resources->getMaterialsMap()) {
+                writer.add_material(material.first, find_or_empty(_resources->getMaterialsPaths(), material.first));
+            }
             for (auto& texture : _resources->getTexturesMap()) {
-                Json textureJson;
-                textureJson["name"] = texture.first;
-                textureJson["path"] = _resources->getTexturesPaths()[texture.first];
-                json["textures"].push_back(textureJson);
-            }
-
-            for (auto& obj : _objects) {
-                Json objJson;
-                objJson["name"] = obj.second.second;
-                objJson["type.id"] = obj.second.first->get_id();
-                objJson["shader"] = _resources->getShaderName(obj.second.first->get_shader());
-                objJson["material"] = _resources->getMaterialName(obj.second.first->get_material());
-                objJson["texture"] = _resources->getTextureName(obj.second.first->get_texture());
-                objJson["uv.x"] = obj.second.first->get_uv().x;
-                objJson["uv.y"] = obj.second.first->get_uv().y;
-                objJson["transform"] = {
-                    {"position", {
-                        {"x", obj.second.first->get_position().x},
-                        {"y", obj.second.first->get_position().y},
-                        {"z", obj.second.first->get_position().z}
-                    }},
-                    {"rotation", {
-                        {"x", obj.second.first->get_rotation().x},
-                        {"y", obj.second.first->get_rotation().y},
-                        {"z", obj.second.first->get_rotation().z}
-                    }},
-                    {"scale", {
-                        {"x", obj.second.first->get_size().x},
-                        {"y", obj.second.first->get_size().y},
-                        {"z", obj.second.first->get_size().z}
-                    }}
-                };
-                objJson["other"] = {};
-
-                json["objects"].push_back(objJson);
-            }
-
-            for (auto& light : _lights) {
-                Json lightJson;
-                lightJson["name"] = light.second.second;
-                lightJson["type.id"] = light.second.first->get_id();
-                lightJson["shader"] = _resources->getShaderName(light.second.first->get_shader());
-                lightJson["material"] = _resources->getMaterialName(light.second.first->get_material());
-                lightJson["texture"] = _resources->getTextureName(light.second.first->get_texture());
-                lightJson["uv.x"] = light.second.first->get_uv().x,
-                lightJson["uv.y"] = light.second.first->get_uv().y,
-                lightJson["transform"] = {
-                    {"position", {
-                        {"x", light.second.first->get_position().x},
-                        {"y", light.second.first->get_position().y},
-                        {"z", light.second.first->get_position().z}
-                    }},
-                    {"rotation", {
-                        {"x", light.second.first->get_rotation().x},
-                        {"y", light.second.first->get_rotation().y},
-                        {"z", light.second.first->get_rotation().z}
-                    }},
-                    {"scale", {
-                        {"x", light.second.first->get_size().x},
-                        {"y", light.second.first->get_size().y},
-                        {"z", light.second.first->get_size().z}
-                    }}
-                };
-                lightJson["other"]["Light"] = {
-                    {"color", {
-                        {"r", light.second.first->get_light_color().r},
-                        {"g", light.second.first->get_light_color().g},
-                        {"b", light.second.first->get_light_color().b}
-                    }}
-                };
-
-                json["objects"].push_back(lightJson);
-            }
-
-            std::fstream file;
-            file.open(path, std::ios::out);
-            if (file.is_open()) {
-                file << json << std::endl;
+                writer.add_texture(texture.first, find_or_empty(_resources->getTexturesPaths(), texture.first),
+                                   find_or_empty(_resources->getTexturesCompression(), texture.first));
+            }
+
+            const ResourceNames names(*_resources);
+
+            update_entities();
+            _registry.each<Novo::ECS::MeshRenderer, Novo::ECS::Transform, Novo::ECS::Name>([&](Novo::ECS::Entity, Novo::ECS::MeshRenderer& renderer, Novo::ECS::Transform& transform, Novo::ECS::Name& name) {
+                Novo::Mesh::MeshBase& mesh = *renderer.mesh;
+
+                Novo::SceneFile::Object object;
+                object.name = name.value;
+                object.type = mesh.get_id();
+                object.shader = names.shader(mesh.get_shader());
+                object.material = names.material(mesh.get_material());
+                object.texture = names.texture(mesh.get_texture());
+                object.uv = mesh.get_uv();
+                object.position = transform.position;
+                object.rotation = transform.rotation;
+                object.scale = transform.scale;
+                writer.add_object(object);
+            });
+
+            _registry.each<Novo::ECS::Light, Novo::ECS::Transform, Novo::ECS::Name>([&](Novo::ECS::Entity, Novo::ECS::Light& light, Novo::ECS::Transform& transform, Novo::ECS::Name& name) {
+                Novo::Mesh::LightSource& source = *light.source;
+
+                Novo::SceneFile::Object object;
+                object.name = name.value;
+                object.type = source.get_id();
+                object.shader = names.shader(source.get_shader());
+                object.material = names.material(source.get_material());
+                object.texture = names.texture(source.get_texture());
+                object.uv = source.get_uv();
+                object.position = transform.position;
+                object.rotation = transform.rotation;
+                object.scale = transform.scale;
+                object.color = light.color;
+                object.radius = light.radius;
+                writer.add_object(object);
+            });
+
+            return writer.write(path);
+        }
+
+        /// Picks the format by extension, .nvscene is the binary format
+        void save(const std::string& path) {
+            if (std::filesystem::path(path).extension() == ".nvscene") {
+                save_to_binary(path);
             } else {
-                std::cerr << "Failed to open file " << path << std::endl;
+                save_to_json(path);
             }
-            return json;
         }
-        
-        void add_object(const Novo::Mesh::MeshBase& obj) {
-            _objects[_lastID] = ObjPair(std::make_shared<Novo::Mesh::MeshBase>(obj), "Scene object #" + std::to_string(_lastID));
-            ++_lastID;
+
+        Novo::ECS::Entity add_object(const Novo::Mesh::MeshBase& obj) {
+            return add_object(std::make_shared<Novo::Mesh::MeshBase>(obj));
         }
 
-        void add_object(const std::shared_ptr<Novo::Mesh::MeshBase>& obj) {
-            _objects[_lastID] = ObjPair(obj, "Scene object #" + std::to_string(_lastID));
-            ++_lastID;
+        Novo::ECS::Entity add_object(const std::shared_ptr<Novo::Mesh::MeshBase>& obj) {
+            return add_object(obj, "Scene object #" + std::to_string(_lastID));
         }
 
-        void add_object(const Novo::Mesh::MeshBase& obj, const std::string& name) {
-            _objects[_lastID] = ObjPair(std::make_shared<Novo::Mesh::MeshBase>(obj), name);
-            ++_lastID;
+        Novo::ECS::Entity add_object(const Novo::Mesh::MeshBase& obj, const std::string& name) {
+            return add_object(std::make_shared<Novo::Mesh::MeshBase>(obj), name);
         }
 
-        void add_object(const std::shared_ptr<Novo::Mesh::MeshBase>& obj, const std::string& name) {
-            _objects[_lastID] = ObjPair(obj, name);
+        Novo::ECS::Entity add_object(const std::shared_ptr<Novo::Mesh::MeshBase>& obj, const std::string& name) {
+            Novo::ECS::Entity entity = _registry.create();
+            _registry.emplace<Novo::ECS::MeshRenderer>(entity, obj);
+            _registry.emplace<Novo::ECS::Transform>(entity);
+            _registry.emplace<Novo::ECS::Name>(entity, name);
+            obj->set_change_list(&_changes, entity.index);
+            _batches_dirty = true;
             ++_lastID;
+            return entity;
         }
 
-        void add_light(const Novo::Mesh::LightSource& light) {
-            _lights[_lastID] = LightPair(std::make_shared<Novo::Mesh::LightSource>(light), "Light #" + std::to_string(_lastID));
-            ++_lastID;
+        Novo::ECS::Entity add_light(const Novo::Mesh::LightSource& light) {
+            return add_light(std::make_shared<Novo::Mesh::LightSource>(light));
         }
 
-        void add_light(const std::shared_ptr<Novo::Mesh::LightSource>& light) {
-            _lights[_lastID] = LightPair(light, "Light #" + std::to_string(_lastID));
-            ++_lastID;
+        Novo::ECS::Entity add_light(const std::shared_ptr<Novo::Mesh::LightSource>& light) {
+            return add_light(light, "Light #" + std::to_string(_lastID));
         }
 
-        void add_light(const Novo::Mesh::LightSource& light, const std::string& name) {
-            _lights[_lastID] = LightPair(std::make_shared<Novo::Mesh::LightSource>(light), name);
-            ++_lastID;
+        Novo::ECS::Entity add_light(const Novo::Mesh::LightSource& light, const std::string& name) {
+            return add_light(std::make_shared<Novo::Mesh::LightSource>(light), name);
         }
 
-        void add_light(const std::shared_ptr<Novo::Mesh::LightSource>& light, const std::string& name) {
-            _lights[_lastID] = LightPair(light, name);
+        Novo::ECS::Entity add_light(const std::shared_ptr<Novo::Mesh::LightSource>& light, const std::string& name) {
+            Novo::ECS::Entity entity = _registry.create();
+            _registry.emplace<Novo::ECS::Light>(entity, light);
+            _registry.emplace<Novo::ECS::Transform>(entity);
+            _registry.emplace<Novo::ECS::Name>(entity, name);
+            light->set_change_list(&_changes, entity.index);
             ++_lastID;
+            return entity;
         }
 
-        void reload_all() {
-            for (auto& obj : _objects) {
-                obj.second.first->reload();
+        /// Removes an object or a light
+        /// @return false if the entity was already removed
+        bool remove(Novo::ECS::Entity entity) {
+            if (!_registry.is_alive(entity)) return false;
+
+            if (Novo::ECS::MeshRenderer* renderer = _registry.try_get<Novo::ECS::MeshRenderer>(entity)) {
+                if (renderer->bvh_node != Novo::BVH::NULL_NODE) _bvh.destroy_proxy(renderer->bvh_node);
+                renderer->mesh->set_change_list(nullptr, 0);
+                _batches_dirty = true;
             }
+            if (Novo::ECS::Light* light = _registry.try_get<Novo::ECS::Light>(entity)) {
+                light->source->set_change_list(nullptr, 0);
+            }
+            _registry.destroy(entity);
+            return true;
+        }
+
+        void reload_all() {
+            _registry.each<Novo::ECS::MeshRenderer>([](Novo::ECS::Entity, Novo::ECS::MeshRenderer& renderer) {
+                renderer.mesh->reload();
+            });
         }
 
         void clear() {
-            _objects.clear();
-            _lights.clear();
+            detach_meshes();
+            _registry.clear();
+            _changes.clear();
+            _bvh.clear();
+            _slots.clear();
+            _visible_unbatched.clear();
+            _batches.clear();
+            _unbatched.clear();
+            _queue.clear();
+            _gizmos.invalidate();
+            _batches_dirty = true;
+        }
+
+        /// Size of the viewport the scene is drawn into, light clusters are laid out over it. Call it from the window's size callback
+        void set_viewport_size(glm::vec2 size) {
+            _viewport_size = size;
+        }
+
+        /// Light gizmos are an editor aid, turn them off for play mode
+        void set_draw_gizmos(bool draw_gizmos) {
+            _draw_gizmos = draw_gizmos;
+        }
+
+        bool get_draw_gizmos() const {
+            return _draw_gizmos;
+        }
+
+        const Novo::StateCache::Stats& get_render_stats() const {
+            return _state.get_stats();
+        }
+
+        /// Casts a ray against the object bounds
+        /// @return closest visible object hit, invalid if none
+        Novo::ECS::Entity pick(const glm::vec3& origin, const glm::vec3& direction, float max_distance = 1000.f) {
+            update_entities();
+            const glm::vec3 inv_direction = glm::vec3(1.f / direction.x, 1.f / direction.y, 1.f / direction.z);
+            Novo::ECS::Entity picked;
+            _bvh.raycast(origin, direction, max_distance, [&](uint32_t index, float max) {
+                const Novo::ECS::Entity entity = _registry.get_entity(index);
+                float t;
+                if (_registry.has<Novo::ECS::Hidden>(entity)) return -1.f;
+                if (!_registry.get<Novo::ECS::Transform>(entity).world_bounds.intersects_ray(origin, inv_direction, max, t)) return -1.f;
+                picked = entity;
+                return t;
+            });
+            return picked;
+        }
+
+        /// Calls `callback(entity, mesh)` for every object whose bounds may touch the light's range
+        template <typename Callback>
+        void for_each_object_in_range(Novo::ECS::Entity light, Callback&& callback) {
+            update_entities();
+            const glm::vec3 center = _registry.get<Novo::ECS::Transform>(light).position;
+            const float radius = _registry.get<Novo::ECS::Light>(light).radius;
+            _bvh.query(Novo::AABB{ center - glm::vec3(radius), center + glm::vec3(radius) }, [&](uint32_t index) {
+                const Novo::ECS::Entity entity = _registry.get_entity(index);
+                callback(entity, *_registry.get<Novo::ECS::MeshRenderer>(entity).mesh);
+            });
         }
 
         void draw_ui() {
             ImGui::Begin(_name.c_str());
             ImGui::SetWindowFontScale(1.5f);
-            static int selected_object = INT_MAX;
-            static std::string selected_object_str = "None [id: " + std::to_string(selected_object) + "]";
+            static Novo::ECS::Entity selected_object;
+            static std::string selected_object_str = "None";
+            auto label = [](Novo::ECS::Entity entity, const std::string& name) {
+                return name + " [id: " + std::to_string(entity.index) + "]";
+            };
             if (ImGui::BeginCombo("Selected object", selected_object_str.c_str())) {
-                if (ImGui::Selectable(("None [id: " + std::to_string(INT_MAX) + "]").c_str())) {
-                    selected_object = INT_MAX;
-                    selected_object_str = "None [id: " + std::to_string(selected_object) + "]";
-                }
-                for (auto& obj : _objects) {
-                    if (ImGui::Selectable((obj.second.second + " [id: " + std::to_string(obj.first) + "]").c_str())) {
-                        selected_object = obj.first;
-                        selected_object_str = obj.second.second + " [id: " + std::to_string(selected_object) + "]";
-                    }
+                if (ImGui::Selectable("None")) {
+                    selected_object = Novo::ECS::Entity();
+                    selected_object_str = "None";
                 }
-                for (auto& light : _lights) {
-                    if (ImGui::Selectable((light.second.second + " [id: " + std::to_string(light.first) + "]").c_str())) {
-                        selected_object = light.first;
-                        selected_object_str = light.second.second + " [id: " + std::to_string(selected_object) + "]";
+                _registry.each<Novo::ECS::Name>([&](Novo::ECS::Entity entity, Novo::ECS::Name& name) {
+                    if (ImGui::Selectable(label(entity, name.value).c_str())) {
+                        selected_object = entity;
+                        selected_object_str = label(entity, name.value);
                     }
-                }
+                });
                 ImGui::EndCombo();
             }
-            for (auto& obj : _objects) if (obj.first == selected_object) {
+            if (_registry.is_alive(selected_object)) {
+                std::string& name = _registry.get<Novo::ECS::Name>(selected_object).value;
+
                 static std::vector<char> buffer(256);
-                if (obj.second.second.size() >= buffer.size()) {
-                    buffer.resize(obj.second.second.size() + 1);
+                if (name.size() >= buffer.size()) {
+                    buffer.resize(name.size() + 1);
                 }
-                memcpy(buffer.data(), obj.second.second.c_str(), obj.second.second.size() + 1);
+                memcpy(buffer.data(), name.c_str(), name.size() + 1);
 
                 if (ImGui::InputText("Name", buffer.data(), buffer.size())) {
-                    obj.second.second.assign(buffer.data());
-                    selected_object_str = obj.second.second + " [id: " + std::to_string(selected_object) + "]";
+                    name.assign(buffer.data());
+                    selected_object_str = label(selected_object, name);
                 }
-                obj.second.first->draw_ui(obj.second.second);
-            }
-            for (auto& light : _lights) if (light.first == selected_object) {
-                static std::vector<char> buffer(256);
-                if (light.second.second.size() >= buffer.size()) {
-                    buffer.resize(light.second.second.size() + 1);
+                if (Novo::ECS::MeshRenderer* renderer = _registry.try_get<Novo::ECS::MeshRenderer>(selected_object)) {
+                    renderer->mesh->draw_ui(name);
+                } else if (Novo::ECS::Light* light = _registry.try_get<Novo::ECS::Light>(selected_object)) {
+                    light->source->draw_ui(name);
                 }
-                memcpy(buffer.data(), light.second.second.c_str(), light.second.second.size() + 1);
 
-                if (ImGui::InputText("Name", buffer.data(), buffer.size())) {
-                    light.second.second.assign(buffer.data());
-                    selected_object_str = light.second.second + " [id: " + std::to_string(selected_object) + "]";
+                if (ImGui::Button("Remove")) {
+                    remove(selected_object);
+                    selected_object = Novo::ECS::Entity();
+                    selected_object_str = "None";
                 }
-                light.second.first->draw_ui(light.second.second);
+            }
+            ImGui::Separator();
+
+            if (ImGui::TreeNode("Render stats")) {
+                const Novo::StateCache::Stats& stats = get_render_stats();
+                ImGui::Text("Batches: %zu", _queue.get_items().size());
+                if (_indirect) ImGui::Text("Multi-draw calls: %zu", _indirect->get_call_count());
+                else ImGui::Text("Multi-draw: not supported");
+                ImGui::Text("Drawn / culled: %zu / %zu", _drawn_count, _culled_count);
+                ImGui::Text("Light gizmos: %zu", _gizmos.get_count());
+                ImGui::Checkbox("Draw light gizmos", &_draw_gizmos);
+                ImGui::Text("BVH nodes / height: %zu / %d", _bvh.get_node_count(), _bvh.get_height());
+                ImGui::Text("State changes issued / skipped");
+                ImGui::Text("Program:  %u / %u", stats.program.issued, stats.program.skipped);
+                ImGui::Text("Texture:  %u / %u", stats.texture.issued, stats.texture.skipped);
+                ImGui::Text("VAO:      %u / %u", stats.vao.issued, stats.vao.skipped);
+                ImGui::Text("Cull:     %u / %u", stats.cull.issued, stats.cull.skipped);
+                ImGui::Text("Material: %u / %u", stats.material.issued, stats.material.skipped);
+                ImGui::TreePop();
             }
             ImGui::Separator();
 
@@ -541,7 +974,7 @@ namespace Novo {
                 }
                 ImGui::Text("Scene file will be saved as:\n%s", (_resources->getExePath() + path).c_str());
                 if (ImGui::Button("Save")) {
-                    save_to_json(_resources->getExePath() + path);
+                    save(_resources->getExePath() + path);
                     isSaving = false;
                 }
                 ImGui::SameLine();
@@ -566,7 +999,7 @@ namespace Novo {
                     }
                     if (ImGui::Button("Open")) {
                         clear();
-                        load_from_json(path);
+                        load(path);
                         reload_all();
                         isOpening = false;
                     }
@@ -581,22 +1014,47 @@ namespace Novo {
         }
 
         void render() {
-            for (auto& obj : _objects) {
-                for (auto& light : _lights) {
-                    if (!light.second.first->is_active()) {
-                        obj.second.first->get_shader()->load();
-                        obj.second.first->get_shader()->insertUniformArray("light_colors", glm::vec3(0.f), light.first);
-                        obj.second.first->get_shader()->unload();
-                        continue;
-                    }
-                    light.second.first->draw();
-                    obj.second.first->get_shader()->load();
-                    obj.second.first->get_shader()->insertUniformArray("light_colors", light.second.first->get_light_color(), light.first);
-                    obj.second.first->get_shader()->insertUniformArray("light_positions", light.second.first->get_position(), light.first);
-                    obj.second.first->get_shader()->unload();
-                }
-                obj.second.first->draw();
+            update_entities();
+
+            Novo::ECS::gather_lights(_registry, _light_buffer);
+            _light_buffer.upload();
+            _light_buffer.bind();
+
+            _cluster_grid.build(*CurrentCamera::get_camera(), _light_buffer.get_lights(), _viewport_size);
+            _cluster_grid.bind();
+
+            if (_batches_dirty) rebuild_batches();
+            _state.reset_stats();
+            _state.invalidate(); // Unbatched meshes and the UI change state behind the cache's back
+
+            const Novo::Frustum frustum = CurrentCamera::get_camera()->get_frustum();
+            Novo::ECS::cull(_registry, _bvh, frustum, _visible, _jobs.get());
+            submit(_visible);
+
+            StagingRing& staging = *_resources->getStagingRing();
+            staging.retire();
+
+            _drawn_count = 0;
+            _culled_count = 0;
+            if (_indirect) _indirect->begin();
+            for (auto& item : _queue.get_items()) {
+                size_t visible = item.batch->end_cull();
+                _drawn_count += visible;
+                _culled_count += item.batch->get_count() - visible;
+                if (visible == 0) continue;
+                if (_indirect) _indirect->add(*item.batch, visible);
+                else item.batch->draw(_state, &staging);
+            }
+            if (_indirect) _indirect->draw(_state, &staging);
+            draw_gizmos();
+            Novo::Shader::unload();
+
+            for (const Novo::ECS::Entity entity : _visible_unbatched) {
+                const Novo::ECS::Transform& transform = _registry.get<Novo::ECS::Transform>(entity);
+                _slots[entity.index].mesh->draw(transform.world, transform.normal);
             }
+            _drawn_count += _visible_unbatched.size();
+            _culled_count += _unbatched.size() - _visible_unbatched.size();
         }
     };
-}
\ No newline at end of file
+}
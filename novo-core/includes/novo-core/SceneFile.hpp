@@ -0,0 +1,386 @@
+#pragma once
+
+#include <novo-core/Mesh/MeshID.hpp>
+#include <novo-core/json.hpp>
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace Novo {
+    /// Versioned binary scene format, made to be used straight from a memory mapped file.
+    /// The file is a Header followed by fixed size little endian tables (shaders, materials, textures, objects)
+    /// and one string blob. Tables refer to strings by offset and objects refer to resources by table index,
+    /// so loading does no parsing and no name lookups
+    namespace SceneFile {
+        using Json = nlohmann::json;
+
+        constexpr char MAGIC[4] = { 'N', 'V', 'S', 'C' };
+        constexpr uint32_t VERSION = 1;
+        constexpr uint32_t NO_RESOURCE = UINT32_MAX;
+
+        struct StringRef {
+            uint32_t offset = 0; // Into the string blob
+            uint32_t length = 0;
+        };
+
+        struct Section {
+            uint32_t offset = 0; // From the start of the file
+            uint32_t count = 0;  // Entries, bytes for the string blob
+        };
+
+        struct Header {
+            char magic[4];
+            uint32_t version;
+            StringRef name;
+            Section shaders;
+            Section materials;
+            Section textures;
+            Section objects;
+            Section strings;
+        };
+
+        struct ShaderEntry {
+            StringRef name;
+            StringRef vertex;
+            StringRef fragment;
+        };
+
+        struct ResourceEntry {
+            StringRef name;
+            StringRef path;
+        };
+
+        struct TextureEntry {
+            StringRef name;
+            StringRef path;
+            StringRef compression; // novo-texcook setting, empty for the default
+        };
+
+        struct ObjectEntry {
+            StringRef name;
+            uint32_t type;     // MeshID
+            uint32_t shader;   // Table indices, NO_RESOURCE if unset
+            uint32_t material;
+            uint32_t texture;
+            float position[3];
+            float rotation[3];
+            float scale[3];
+            float uv[2];
+            float color[3];    // Lights only
+            float radius;      // Lights only
+        };
+
+        static_assert(std::is_trivially_copyable<Header>::value && sizeof(Header) == 56, "Header layout is part of the format");
+        static_assert(sizeof(ShaderEntry) == 24 && sizeof(ResourceEntry) == 16 && sizeof(TextureEntry) == 24 && sizeof(ObjectEntry) == 84,
+                      "Entry layouts are part of the format");
+
+        /// Entries of one table, pointing into the mapped file
+        template <typename T>
+        struct Table {
+            const T* data = nullptr;
+            size_t count = 0;
+
+            const T* begin() const { return data; }
+            const T* end() const { return data + count; }
+            const T& operator[](size_t index) const { return data[index]; }
+            size_t size() const { return count; }
+        };
+
+        /// Bounds checked access to a scene file in memory. Does not copy or own the data
+        class View {
+        private:
+            const unsigned char* _data = nullptr;
+            size_t _size = 0;
+            bool _valid = false;
+
+            template <typename T>
+            bool check(const Section& section) const {
+                return section.offset % alignof(T) == 0 && section.offset <= _size && section.count <= (_size - section.offset) / sizeof(T);
+            }
+
+            template <typename T>
+            Table<T> table(const Section& section) const {
+                if (!_valid) return {};
+                return { reinterpret_cast<const T*>(_data + section.offset), section.count };
+            }
+        public:
+            /// @param data must stay alive while the view is used, and be 4 byte aligned (a mapping always is)
+            View(const void* data, size_t size) : _data(static_cast<const unsigned char*>(data)), _size(size) {
+                if (!_data || _size < sizeof(Header)) return;
+
+                const Header& header = get_header();
+                _valid = std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0
+                      && header.version == VERSION
+                      && check<ShaderEntry>(header.shaders)
+                      && check<ResourceEntry>(header.materials)
+                      && check<TextureEntry>(header.textures)
+                      && check<ObjectEntry>(header.objects)
+                      && check<char>(header.strings);
+            }
+
+            bool is_valid() const {
+                return _valid;
+            }
+
+            const Header& get_header() const {
+                return *reinterpret_cast<const Header*>(_data);
+            }
+
+            /// @return empty string for references outside the blob
+            std::string_view get_string(const StringRef& ref) const {
+                const Section& strings = get_header().strings;
+                if (ref.offset > strings.count || ref.length > strings.count - ref.offset) return {};
+                return { reinterpret_cast<const char*>(_data + strings.offset + ref.offset), ref.length };
+            }
+
+            std::string_view get_name() const { return get_string(get_header().name); }
+            Table<ShaderEntry> get_shaders() const { return table<ShaderEntry>(get_header().shaders); }
+            Table<ResourceEntry> get_materials() const { return table<ResourceEntry>(get_header().materials); }
+            Table<TextureEntry> get_textures() const { return table<TextureEntry>(get_header().textures); }
+            Table<ObjectEntry> get_objects() const { return table<ObjectEntry>(get_header().objects); }
+        };
+
+        /// Scene object with resources referenced by name, as the writers and the JSON reader pass it around
+        struct Object {
+            std::string name;
+            MeshID type = MeshID::MeshBase;
+            std::string shader;
+            std::string material;
+            std::string texture;
+            glm::vec3 position = glm::vec3(0.f);
+            glm::vec3 rotation = glm::vec3(0.f);
+            glm::vec3 scale = glm::vec3(1.f);
+            glm::vec2 uv = glm::vec2(1.f);
+            glm::vec3 color = glm::vec3(1.f); // Lights only
+            float radius = 10.f;              // Lights only
+        };
+
+        /// Collects a scene and lays it out in the binary format
+        class Writer {
+        private:
+            std::string _strings;
+            std::unordered_map<std::string, StringRef> _string_refs; // Equal strings are stored once
+
+            StringRef _name;
+            std::vector<ShaderEntry> _shaders;
+            std::vector<ResourceEntry> _materials;
+            std::vector<TextureEntry> _textures;
+            std::vector<ObjectEntry> _objects;
+
+            std::unordered_map<std::string, uint32_t> _shader_indices;
+            std::unordered_map<std::string, uint32_t> _material_indices;
+            std::unordered_map<std::string, uint32_t> _texture_indices;
+
+            StringRef add_string(const std::string& value) {
+                auto found = _string_refs.find(value);
+                if (found != _string_refs.end()) return found->second;
+
+                const StringRef ref = { static_cast<uint32_t>(_strings.size()), static_cast<uint32_t>(value.size()) };
+                _strings += value;
+                _string_refs.emplace(value, ref);
+                return ref;
+            }
+
+            static uint32_t find(const std::unordered_map<std::string, uint32_t>& indices, const std::string& name) {
+                auto found = indices.find(name);
+                return found == indices.end() ? NO_RESOURCE : found->second;
+            }
+
+            static size_t align(size_t offset) {
+                return (offset + 3) & ~size_t(3);
+            }
+
+            template <typename T>
+            static Section place(size_t& offset, const std::vector<T>& entries) {
+                const Section section = { static_cast<uint32_t>(offset), static_cast<uint32_t>(entries.size()) };
+                offset = align(offset + entries.size() * sizeof(T));
+                return section;
+            }
+
+            template <typename T>
+            static void copy(std::vector<unsigned char>& out, const Section& section, const std::vector<T>& entries) {
+                if (!entries.empty()) std::memcpy(out.data() + section.offset, entries.data(), entries.size() * sizeof(T));
+            }
+        public:
+            void set_name(const std::string& name) {
+                _name = add_string(name);
+            }
+
+            void add_shader(const std::string& name, const std::string& vertex, const std::string& fragment) {
+                _shader_indices[name] = static_cast<uint32_t>(_shaders.size());
+                _shaders.push_back({ add_string(name), add_string(vertex), add_string(fragment) });
+            }
+
+            void add_material(const std::string& name, const std::string& path) {
+                _material_indices[name] = static_cast<uint32_t>(_materials.size());
+                _materials.push_back({ add_string(name), add_string(path) });
+            }
+
+            void add_texture(const std::string& name, const std::string& path, const std::string& compression = std::string()) {
+                _texture_indices[name] = static_cast<uint32_t>(_textures.size());
+                _textures.push_back({ add_string(name), add_string(path), add_string(compression) });
+            }
+
+            /// Resources are referenced by name and must be added first
+            void add_object(const Object& object) {
+                ObjectEntry entry;
+                entry.name = add_string(object.name);
+                entry.type = static_cast<uint32_t>(object.type);
+                entry.shader = find(_shader_indices, object.shader);
+                entry.material = find(_material_indices, object.material);
+                entry.texture = find(_texture_indices, object.texture);
+                for (int i = 0; i < 3; ++i) {
+                    entry.position[i] = object.position[i];
+                    entry.rotation[i] = object.rotation[i];
+                    entry.scale[i] = object.scale[i];
+                    entry.color[i] = object.color[i];
+                }
+                entry.uv[0] = object.uv.x;
+                entry.uv[1] = object.uv.y;
+                entry.radius = object.radius;
+                _objects.push_back(entry);
+            }
+
+            void reserve_objects(size_t count) {
+                _objects.reserve(count);
+            }
+
+            std::vector<unsigned char> build() const {
+                Header header;
+                std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+                header.version = VERSION;
+                header.name = _name;
+
+                size_t offset = align(sizeof(Header));
+                header.shaders = place(offset, _shaders);
+                header.materials = place(offset, _materials);
+                header.textures = place(offset, _textures);
+                header.objects = place(offset, _objects);
+                header.strings = { static_cast<uint32_t>(offset), static_cast<uint32_t>(_strings.size()) };
+
+                std::vector<unsigned char> out(offset + _strings.size(), 0);
+                std::memcpy(out.data(), &header, sizeof(header));
+                copy(out, header.shaders, _shaders);
+                copy(out, header.materials, _materials);
+                copy(out, header.textures, _textures);
+                copy(out, header.objects, _objects);
+                std::memcpy(out.data() + header.strings.offset, _strings.data(), _strings.size());
+                return out;
+            }
+
+            bool write(const std::string& path) const {
+                const std::vector<unsigned char> data = build();
+                std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+                if (!file.is_open()) {
+                    std::cerr << "Failed to open file " << path << std::endl;
+                    return false;
+                }
+                file.write(reinterpret_cast<const char*>(data.data()), data.size());
+                return static_cast<bool>(file);
+            }
+        };
+
+        inline glm::vec3 vec3_from_json(const Json& json, const char* x, const char* y, const char* z) {
+            return glm::vec3(json.value(x, 0.f), json.value(y, 0.f), json.value(z, 0.f));
+        }
+
+        /// Fills `writer` from a scene in the JSON format written by Scene::save_to_json
+        inline void from_json(const Json& json, Writer& writer) {
+            writer.set_name(json.value("name", std::string("Scene")));
+
+            for (const auto& shader : json.value("shaders", Json::array())) {
+                writer.add_shader(shader["name"], shader["vs"], shader["fs"]);
+            }
+            for (const auto& material : json.value("materials", Json::array())) {
+                writer.add_material(material["name"], material["path"]);
+            }
+            for (const auto& texture : json.value("textures", Json::array())) {
+                writer.add_texture(texture["name"], texture["path"], texture.value("compression", std::string()));
+            }
+
+            const Json objects = json.value("objects", Json::array());
+            writer.reserve_objects(objects.size());
+            for (const auto& obj : objects) {
+                Object object;
+                object.name = obj.value("name", std::string());
+                object.type = static_cast<MeshID>(obj.value("type.id", 0));
+                object.shader = obj.value("shader", std::string());
+                object.material = obj.value("material", std::string());
+                object.texture = obj.value("texture", std::string());
+                object.uv = glm::vec2(obj.value("uv.x", 1.f), obj.value("uv.y", 1.f));
+
+                const Json& transform = obj["transform"];
+                object.position = vec3_from_json(transform["position"], "x", "y", "z");
+                object.rotation = vec3_from_json(transform["rotation"], "x", "y", "z");
+                object.scale = vec3_from_json(transform["scale"], "x", "y", "z");
+
+                if (obj.contains("other") && obj["other"].contains("Light")) {
+                    const Json& light = obj["other"]["Light"];
+                    object.color = vec3_from_json(light["color"], "r", "g", "b");
+                    object.radius = light.value("radius", object.radius);
+                }
+                writer.add_object(object);
+            }
+        }
+
+        /// Converts back to the JSON format, e.g. to edit a scene by hand
+        inline Json to_json(const View& view) {
+            auto str = [&](const StringRef& ref) { return std::string(view.get_string(ref)); };
+            auto vec3 = [](const float* v, const char* x, const char* y, const char* z) {
+                return Json{ {x, v[0]}, {y, v[1]}, {z, v[2]} };
+            };
+
+            Json json;
+            json["name"] = std::string(view.get_name());
+            json["shaders"] = Json::array();
+            json["materials"] = Json::array();
+            json["textures"] = Json::array();
+            json["objects"] = Json::array();
+
+            for (const ShaderEntry& shader : view.get_shaders()) {
+                json["shaders"].push_back({ {"name", str(shader.name)}, {"vs", str(shader.vertex)}, {"fs", str(shader.fragment)} });
+            }
+            for (const ResourceEntry& material : view.get_materials()) {
+                json["materials"].push_back({ {"name", str(material.name)}, {"path", str(material.path)} });
+            }
+            for (const TextureEntry& texture : view.get_textures()) {
+                Json entry = { {"name", str(texture.name)}, {"path", str(texture.path)} };
+                if (texture.compression.length > 0) entry["compression"] = str(texture.compression);
+                json["textures"].push_back(entry);
+            }
+
+            auto resource_name = [&](const auto& table, uint32_t index) {
+                return index < table.size() ? str(table[index].name) : std::string();
+            };
+            for (const ObjectEntry& object : view.get_objects()) {
+                Json obj;
+                obj["name"] = str(object.name);
+                obj["type.id"] = object.type;
+                obj["shader"] = resource_name(view.get_shaders(), object.shader);
+                obj["material"] = resource_name(view.get_materials(), object.material);
+                obj["texture"] = resource_name(view.get_textures(), object.texture);
+                obj["uv.x"] = object.uv[0];
+                obj["uv.y"] = object.uv[1];
+                obj["transform"] = {
+                    {"position", vec3(object.position, "x", "y", "z")},
+                    {"rotation", vec3(object.rotation, "x", "y", "z")},
+                    {"scale", vec3(object.scale, "x", "y", "z")}
+                };
+                obj["other"] = Json::object();
+                if (object.type == static_cast<uint32_t>(MeshID::Light)) {
+                    obj["other"]["Light"] = { {"color", vec3(object.color, "r", "g", "b")}, {"radius", object.radius} };
+                }
+                json["objects"].push_back(obj);
+            }
+            return json;
+        }
+    }
+}
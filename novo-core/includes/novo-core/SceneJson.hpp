@@ -0,0 +1,161 @@
+#pragma once
+
+#include <novo-core/SceneFile.hpp>
+#include <novo-core/json.hpp>
+
+#include <string>
+#include <vector>
+
+namespace Novo {
+    /// Streaming reader for JSON scenes. Sections are handed out as soon as they are parsed, no DOM is built
+    namespace SceneJson {
+        using Json = nlohmann::json;
+
+        /// Receives the parts of a scene in file order. Objects may come before the resources they use
+        class Handler {
+        public:
+            virtual ~Handler() = default;
+
+            virtual void on_name(const std::string& name) {}
+            virtual void on_shader(const std::string& name, const std::string& vertex, const std::string& fragment) {}
+            virtual void on_material(const std::string& name, const std::string& path) {}
+            /// @param compression novo-texcook setting, empty if the entry has none
+            virtual void on_texture(const std::string& name, const std::string& path, const std::string& compression) {}
+            virtual void on_object(SceneFile::Object& object) {}
+        };
+
+        /// SAX consumer tracking the key path of every value. Keys it doesn't know are skipped with their values
+        class Reader : public nlohmann::json_sax<Json> {
+        private:
+            Handler& _handler;
+            std::vector<std::string> _path; // Current key of every open object, "[]" for arrays
+
+            std::string _fields[3]; // name, path or vs, fs or compression of the current resource
+            SceneFile::Object _object;
+            std::string _error;
+
+            bool in_entry(const char* section) const {
+                return _path.size() >= 3 && _path[1] == "[]" && _path[0] == section;
+            }
+
+            static int component(const std::string& key, const char* names) {
+                for (int i = 0; i < 3; ++i) {
+                    if (key.size() == 1 && key[0] == names[i]) return i;
+                }
+                return -1;
+            }
+
+            void on_number(float value) {
+                if (!in_entry("objects")) return;
+
+                const std::string& key = _path.back();
+                if (_path.size() == 3) {
+                    if (key == "type.id") _object.type = static_cast<MeshID>(static_cast<int>(value));
+                    else if (key == "uv.x") _object.uv.x = value;
+                    else if (key == "uv.y") _object.uv.y = value;
+                } else if (_path.size() == 5 && _path[2] == "transform") {
+                    const int i = component(key, "xyz");
+                    if (i < 0) return;
+                    if (_path[3] == "position") _object.position[i] = value;
+                    else if (_path[3] == "rotation") _object.rotation[i] = value;
+                    else if (_path[3] == "scale") _object.scale[i] = value;
+                } else if (_path.size() >= 5 && _path[2] == "other" && _path[3] == "Light") {
+                    if (_path.size() == 5 && key == "radius") {
+                        _object.radius = value;
+                    } else if (_path.size() == 6 && _path[4] == "color") {
+                        const int i = component(key, "rgb");
+                        if (i >= 0) _object.color[i] = value;
+                    }
+                }
+            }
+
+            void on_string(std::string& value) {
+                if (_path.empty()) return;
+                const std::string& key = _path.back();
+                if (_path.size() == 1 && key == "name") {
+                    _handler.on_name(value);
+                } else if (in_entry("objects") && _path.size() == 3) {
+                    if (key == "name") _object.name = std::move(value);
+                    else if (key == "shader") _object.shader = std::move(value);
+                    else if (key == "material") _object.material = std::move(value);
+                    else if (key == "texture") _object.texture = std::move(value);
+                } else if (_path.size() == 3 && _path[1] == "[]") {
+                    if (key == "name") _fields[0] = std::move(value);
+                    else if (key == "path" || key == "vs") _fields[1] = std::move(value);
+                    else if (key == "fs" || key == "compression") _fields[2] = std::move(value);
+                }
+            }
+
+            /// Called when an array element of a top level section ends
+            void end_entry() {
+                if (_path[0] == "objects") {
+                    _handler.on_object(_object);
+                } else if (_path[0] == "shaders") {
+                    _handler.on_shader(_fields[0], _fields[1], _fields[2]);
+                } else if (_path[0] == "materials") {
+                    _handler.on_material(_fields[0], _fields[1]);
+                } else if (_path[0] == "textures") {
+                    _handler.on_texture(_fields[0], _fields[1], _fields[2]);
+                }
+            }
+        public:
+            explicit Reader(Handler& handler) : _handler(handler) {}
+
+            bool null() override { return true; }
+            bool boolean(bool) override { return true; }
+            bool number_integer(number_integer_t value) override { on_number(static_cast<float>(value)); return true; }
+            bool number_unsigned(number_unsigned_t value) override { on_number(static_cast<float>(value)); return true; }
+            bool number_float(number_float_t value, const string_t&) override { on_number(static_cast<float>(value)); return true; }
+            bool string(string_t& value) override { on_string(value); return true; }
+            bool binary(binary_t&) override { return true; }
+
+            bool start_object(std::size_t) override {
+                if (_path.size() == 2 && _path[1] == "[]") { // New entry of a section
+                    _object = SceneFile::Object();
+                    for (auto& field : _fields) field.clear();
+                }
+                _path.emplace_back();
+                return true;
+            }
+
+            bool key(string_t& value) override {
+                _path.back() = value;
+                return true;
+            }
+
+            bool end_object() override {
+                if (_path.size() == 3 && _path[1] == "[]") end_entry();
+                _path.pop_back();
+                return true;
+            }
+
+            bool start_array(std::size_t) override {
+                _path.emplace_back("[]");
+                return true;
+            }
+
+            bool end_array() override {
+                _path.pop_back();
+                return true;
+            }
+
+            bool parse_error(std::size_t position, const std::string&, const nlohmann::detail::exception& error) override {
+                _error = error.what();
+                return false;
+            }
+
+            const std::string& get_error() const {
+                return _error;
+            }
+        };
+
+        /// Parses the scene in [`begin`, `end`) and feeds it to `handler`
+        /// @return false on a syntax error, which is written to `error`. Parts handed out before the error stay valid
+        inline bool read(const char* begin, const char* end, Handler& handler, std::string& error) {
+            Reader reader(handler);
+            const bool parsed = Json::sax_parse(begin, end, &reader);
+            error = reader.get_error();
+            return parsed;
+        }
+    }
+}
@@ -4,14 +4,55 @@
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <cstring>
 #include <iostream>
+#include <string>
+#include <vector>
+#include <unordered_map>
 
 namespace Novo {
+    /// Resolved uniform location. Fetch once with Shader::getUniform and reuse on every draw.
+    struct UniformHandle {
+        GLint location = -1;
+
+        bool isValid() const {
+            return location >= 0;
+        }
+    };
+
     class Shader {
     private:
+        static bool hasExtension(const char* name) {
+            GLint count = 0;
+            glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+            for (GLint i = 0; i < count; ++i) {
+                const char* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+                if (extension && std::strcmp(extension, name) == 0) return true;
+            }
+            return false;
+        }
+
+        /// Shaders are written for GLSL 4.60. Older contexts compile them as 4.30, which is all they need except gl_DrawID.
+        /// NOVO_DRAW_ID is defined wherever a draw id exists, shaders must not use gl_DrawID directly
+        static std::string preprocess(const std::string& source) {
+            const size_t lineEnd = source.find('\n');
+            if (lineEnd == std::string::npos || source.compare(0, 9, "#version ") != 0) return source;
+
+            std::string version = source.substr(0, lineEnd);
+            std::string prelude;
+            if (GLAD_GL_VERSION_4_6) {
+                prelude = "#define NOVO_DRAW_ID gl_DrawID\n";
+            } else {
+                if (version == "#version 460") version = "#version 430";
+                if (supportsDrawID()) prelude = "#extension GL_ARB_shader_draw_parameters : require\n#define NOVO_DRAW_ID gl_DrawIDARB\n";
+            }
+            return version + "\n" + prelude + "#line 2\n" + source.substr(lineEnd + 1);
+        }
+
         static bool compileShader(const std::string& source, const GLenum shaderType, GLuint& shaderID) {
             shaderID = glCreateShader(shaderType);
-            const char* code = source.c_str();
+            const std::string preprocessed = preprocess(source);
+            const char* code = preprocessed.c_str();
             glShaderSource(shaderID, 1, &code, nullptr);
             glCompileShader(shaderID);
 
@@ -34,11 +75,52 @@ namespace Novo {
         bool _attachedVS = false;
         GLuint _shaderID = 0;
 
+        std::unordered_map<std::string, GLint> _uniforms; // first - name, second - location
+
+        void cacheUniforms() {
+            _uniforms.clear();
+
+            GLint count = 0;
+            GLint maxLength = 0;
+            glGetProgramiv(_shaderID, GL_ACTIVE_UNIFORMS, &count);
+            glGetProgramiv(_shaderID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+            std::vector<GLchar> buffer(maxLength + 1);
+            for (GLint i = 0; i < count; ++i) {
+                GLint size = 0;
+                GLenum type = 0;
+                GLsizei length = 0;
+                glGetActiveUniform(_shaderID, i, maxLength, &length, &size, &type, buffer.data());
+
+                std::string name(buffer.data(), length);
+                GLint location = glGetUniformLocation(_shaderID, name.c_str());
+                if (location < 0) continue; // Uniform block members have no location
+
+                // Arrays are reported as "name[0]", register the base name and every element
+                if (size > 1 && name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0) {
+                    std::string base = name.substr(0, name.size() - 3);
+                    _uniforms[base] = location;
+                    for (GLint j = 0; j < size; ++j) {
+                        std::string element = base + "[" + std::to_string(j) + "]";
+                        _uniforms[element] = glGetUniformLocation(_shaderID, element.c_str());
+                    }
+                } else {
+                    _uniforms[name] = location;
+                }
+            }
+        }
+
     public:
         Shader() {
             init();
         }
 
+        /// Whether vertex shaders can read the draw id of multi-draws, core since GL 4.6
+        static bool supportsDrawID() {
+            static const bool supported = GLAD_GL_VERSION_4_6 || hasExtension("GL_ARB_shader_draw_parameters");
+            return supported;
+        }
+
         Shader(const std::string& vertexSource, const std::string& fragmentSource) {
             GLuint vertexShaderID = addShader(vertexSource, GL_VERTEX_SHADER);
             GLuint fragmentShaderID = addShader(fragmentSource, GL_FRAGMENT_SHADER);
@@ -88,6 +170,7 @@ namespace Novo {
                 std::cerr << "Shader link error:\n" << infolog << std::endl;
             } else {
                 _isLinked = true;
+                cacheUniforms();
             }
         }
 
@@ -95,6 +178,10 @@ namespace Novo {
             return _isLinked;
         }
 
+        GLuint getID() const {
+            return _shaderID;
+        }
+
         void load() const {
             glUseProgram(_shaderID);
         }
@@ -103,24 +190,60 @@ namespace Novo {
             glUseProgram(0);
         }
 
+        UniformHandle getUniform(const std::string& name) const {
+            auto it = _uniforms.find(name);
+            if (it == _uniforms.end()) {
+                return UniformHandle();
+            }
+            return UniformHandle{it->second};
+        }
+
+        void setUniform(const UniformHandle handle, const GLint value) {
+            glUniform1i(handle.location, value);
+        }
+
+        void setUniform(const UniformHandle handle, const GLfloat value) {
+            glUniform1f(handle.location, value);
+        }
+
+        void setUniform(const UniformHandle handle, const glm::vec2& vector) {
+            glUniform2fv(handle.location, 1, glm::value_ptr(vector));
+        }
+
+        void setUniform(const UniformHandle handle, const glm::vec3& vector) {
+            glUniform3fv(handle.location, 1, glm::value_ptr(vector));
+        }
+
+        void setUniform(const UniformHandle handle, const glm::mat3& matrix) {
+            glUniformMatrix3fv(handle.location, 1, GL_FALSE, glm::value_ptr(matrix));
+        }
+
+        void setUniform(const UniformHandle handle, const glm::mat4& matrix) {
+            glUniformMatrix4fv(handle.location, 1, GL_FALSE, glm::value_ptr(matrix));
+        }
+
         void setUniform(const std::string& name, const GLint value) {
-            glUniform1i(glGetUniformLocation(_shaderID, name.c_str()), value);
+            setUniform(getUniform(name), value);
         }
 
         void setUniform(const std::string& name, const GLfloat value) {
-            glUniform1f(glGetUniformLocation(_shaderID, name.c_str()), value);
+            setUniform(getUniform(name), value);
         }
 
         void setUniform(const std::string& name, const glm::vec2& vector) {
-            glUniform2fv(glGetUniformLocation(_shaderID, name.c_str()), 1, glm::value_ptr(vector));
+            setUniform(getUniform(name), vector);
         }
 
         void setUniform(const std::string& name, const glm::vec3& vector) {
-            glUniform3fv(glGetUniformLocation(_shaderID, name.c_str()), 1, glm::value_ptr(vector));
+            setUniform(getUniform(name), vector);
+        }
+
+        void setUniform(const std::string& name, const glm::mat3& matrix) {
+            setUniform(getUniform(name), matrix);
         }
 
         void setUniform(const std::string& name, const glm::mat4& matrix) {
-            glUniformMatrix4fv(glGetUniformLocation(_shaderID, name.c_str()), 1, GL_FALSE, glm::value_ptr(matrix));
+            setUniform(getUniform(name), matrix);
         }
 
         template<typename T>
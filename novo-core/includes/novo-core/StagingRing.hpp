@@ -0,0 +1,114 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+
+namespace Novo {
+    /// Persistently mapped upload buffer used as a ring. Any thread may allocate and write a region,
+    /// the GL thread issues the copy out of it (texture upload from GL_PIXEL_UNPACK_BUFFER, glCopyNamedBufferSubData)
+    /// and fences it. Regions are recycled in allocation order once their fence has passed, so a region that stays
+    /// unfenced holds back every region after it. Producers that fence late should get a ring of their own
+    class StagingRing {
+    public:
+        struct Allocation {
+            unsigned char* data = nullptr; // Mapped memory, write only
+            size_t offset = 0;             // Offset inside the buffer, for GL calls
+            size_t size = 0;
+            uint64_t ticket = 0;
+
+            explicit operator bool() const {
+                return data != nullptr;
+            }
+        };
+    private:
+        struct Region {
+            size_t consumed;        // Bytes taken from the ring, alignment and wrap padding included
+            GLsync fence = nullptr; // Set by fence(), the region is free once it is signaled
+        };
+
+        GLuint _id = 0;
+        unsigned char* _data = nullptr;
+        size_t _capacity;
+
+        size_t _head = 0;
+        size_t _used = 0;
+        std::deque<Region> _regions;
+        uint64_t _first_ticket = 0; // Ticket of _regions.front()
+        std::mutex _mutex;
+    public:
+        explicit StagingRing(size_t capacity) : _capacity(capacity) {
+            const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            glCreateBuffers(1, &_id);
+            glNamedBufferStorage(_id, capacity, nullptr, flags);
+            _data = static_cast<unsigned char*>(glMapNamedBufferRange(_id, 0, capacity, flags));
+        }
+
+        ~StagingRing() {
+            for (Region& region : _regions) {
+                if (region.fence) glDeleteSync(region.fence);
+            }
+            glUnmapNamedBuffer(_id);
+            glDeleteBuffers(1, &_id);
+        }
+
+        StagingRing(const StagingRing&) = delete;
+        StagingRing& operator=(const StagingRing&) = delete;
+
+        /// Takes `size` bytes from the ring. Never blocks, safe to call from any thread
+        /// @return empty allocation if the ring has no room until the GPU catches up, callers fall back to a direct upload
+        Allocation allocate(size_t size, size_t alignment = 4) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (!_data || size == 0 || size > _capacity) return {};
+
+            size_t offset = (_head + alignment - 1) / alignment * alignment;
+            size_t consumed = offset - _head + size;
+            if (offset + size > _capacity) { // Skip the end of the buffer and start over at 0
+                offset = 0;
+                consumed = _capacity - _head + size;
+            }
+            if (_used + consumed > _capacity) return {};
+
+            _head = (offset + size) % _capacity;
+            _used += consumed;
+            _regions.push_back({ consumed });
+            return { _data + offset, offset, size, _first_ticket + _regions.size() - 1 };
+        }
+
+        /// Marks the region as used by the GL commands issued so far. GL thread only
+        void fence(const Allocation& allocation) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            Region& region = _regions[allocation.ticket - _first_ticket];
+            region.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        }
+
+        /// Frees the regions the GPU is done with, without waiting. GL thread only, call once per frame
+        void retire() {
+            std::lock_guard<std::mutex> lock(_mutex);
+            while (!_regions.empty() && _regions.front().fence) {
+                Region& region = _regions.front();
+                const GLenum status = glClientWaitSync(region.fence, 0, 0);
+                if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) break;
+
+                glDeleteSync(region.fence);
+                _used -= region.consumed;
+                _regions.pop_front();
+                ++_first_ticket;
+            }
+            if (_regions.empty()) {
+                _head = 0;
+            }
+        }
+
+        GLuint getID() const {
+            return _id;
+        }
+
+        size_t get_capacity() const {
+            return _capacity;
+        }
+    };
+}
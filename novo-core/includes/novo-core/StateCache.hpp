@@ -0,0 +1,122 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <novo-core/Material.hpp>
+#include <novo-core/VAO.hpp>
+
+#include <array>
+#include <cstdint>
+
+namespace Novo {
+    /// Remembers the GL state set through it and skips calls that wouldn't change anything.
+    /// Call invalidate() whenever something else may have touched the same state.
+    class StateCache {
+    public:
+        struct Counter {
+            uint32_t issued = 0;
+            uint32_t skipped = 0;
+        };
+
+        struct Stats {
+            Counter program;
+            Counter texture;
+            Counter vao;
+            Counter cull;
+            Counter material;
+
+            uint32_t total_skipped() const {
+                return program.skipped + texture.skipped + vao.skipped + cull.skipped + material.skipped;
+            }
+        };
+
+        static constexpr size_t TEXTURE_UNITS = 16;
+    private:
+        static constexpr GLuint UNKNOWN = ~0u;
+
+        GLuint _program = UNKNOWN;
+        std::array<GLuint, TEXTURE_UNITS> _textures;
+        GLuint _vao = UNKNOWN;
+        GLenum _cull_face = UNKNOWN;
+        const Material* _material = nullptr;
+
+        Stats _stats;
+
+        static bool count(Counter& counter, bool changed) {
+            if (changed) ++counter.issued;
+            else ++counter.skipped;
+            return changed;
+        }
+    public:
+        StateCache() {
+            invalidate();
+        }
+
+        void invalidate() {
+            _program = UNKNOWN;
+            _textures.fill(UNKNOWN);
+            _vao = UNKNOWN;
+            _cull_face = UNKNOWN;
+            _material = nullptr;
+            VAO::invalidate();
+        }
+
+        void reset_stats() {
+            _stats = Stats();
+        }
+
+        const Stats& get_stats() const {
+            return _stats;
+        }
+
+        /// @return true if the program was switched. Uniforms set for the previous program don't carry over
+        bool use_program(GLuint program) {
+            if (!count(_stats.program, _program != program)) return false;
+            glUseProgram(program);
+            _program = program;
+            _material = nullptr;
+            return true;
+        }
+
+        bool bind_texture(GLuint unit, GLuint texture) {
+            if (unit >= TEXTURE_UNITS) {
+                glBindTextureUnit(unit, texture);
+                return true;
+            }
+            if (!count(_stats.texture, _textures[unit] != texture)) return false;
+            glBindTextureUnit(unit, texture);
+            _textures[unit] = texture;
+            return true;
+        }
+
+        bool bind_vao(GLuint vao) {
+            if (!count(_stats.vao, _vao != vao)) return false;
+            VAO::bind(vao); // Keeps VAO's own tracking in sync for draws outside the cache
+            _vao = vao;
+            return true;
+        }
+
+        /// GL_NONE disables face culling, front faces are always counter-clockwise
+        bool set_cull_face(GLenum cull_face) {
+            if (!count(_stats.cull, _cull_face != cull_face)) return false;
+            if (cull_face == GL_NONE) {
+                glDisable(GL_CULL_FACE);
+            } else {
+                if (_cull_face == GL_NONE || _cull_face == UNKNOWN) {
+                    glEnable(GL_CULL_FACE);
+                    glFrontFace(GL_CCW);
+                }
+                glCullFace(cull_face);
+            }
+            _cull_face = cull_face;
+            return true;
+        }
+
+        /// Tracks which material's factors are loaded into the current program's uniforms
+        /// @return true if the caller has to upload them
+        bool use_material(const Material* material) {
+            if (!count(_stats.material, _material != material)) return false;
+            _material = material;
+            return true;
+        }
+    };
+}
@@ -3,12 +3,25 @@
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 
+#include <novo-core/CompressedImage.hpp>
+
+// S3TC is an extension, BC1 and BC3 are the same formats under their DirectX names
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
 namespace Novo {
     class Texture2D {
     private:
-        GLuint _id;
-    public:
-        Texture2D(const unsigned char* texture, const glm::vec2& size, const unsigned int channels, const GLenum wrap = GL_REPEAT, const GLenum min_filter = GL_LINEAR_MIPMAP_LINEAR, const GLenum mag_filter = GL_LINEAR) {
+        GLuint _id = 0;
+        GLenum _wrap;
+        GLenum _min_filter;
+        GLenum _mag_filter;
+
+        void create(const unsigned char* texture, const glm::vec2& size, const unsigned int channels) {
             GLenum internalFormat;
             GLenum format;
             switch (channels) {
@@ -31,18 +44,93 @@ namespace Novo {
             glTextureStorage2D(_id, mip_levels, internalFormat, size.x, size.y);
             glTextureSubImage2D(_id, 0, 0, 0, size.x, size.y, format, GL_UNSIGNED_BYTE, texture);
             
-            glTextureParameteri(_id, GL_TEXTURE_WRAP_S, wrap);
-            glTextureParameteri(_id, GL_TEXTURE_WRAP_T, wrap);
-            glTextureParameteri(_id, GL_TEXTURE_MIN_FILTER, min_filter);
-            glTextureParameteri(_id, GL_TEXTURE_MAG_FILTER, mag_filter);
+            glTextureParameteri(_id, GL_TEXTURE_WRAP_S, _wrap);
+            glTextureParameteri(_id, GL_TEXTURE_WRAP_T, _wrap);
+            glTextureParameteri(_id, GL_TEXTURE_MIN_FILTER, _min_filter);
+            glTextureParameteri(_id, GL_TEXTURE_MAG_FILTER, _mag_filter);
 
             glGenerateTextureMipmap(_id);
         }
 
+        /// Uploads every level of the mip chain as is, nothing is generated at runtime.
+        /// `data` is the start of the image's data, or an offset if a pixel unpack buffer is bound
+        void create(const CompressedImage& image, const unsigned char* data) {
+            const GLenum format = toGL(image.format);
+            const GLsizei levels = static_cast<GLsizei>(image.levels.size());
+
+            glCreateTextures(GL_TEXTURE_2D, 1, &_id);
+            glTextureStorage2D(_id, levels, format, image.get_width(), image.get_height());
+            for (GLsizei i = 0; i < levels; ++i) {
+                const CompressedImage::Level& level = image.levels[i];
+                glCompressedTextureSubImage2D(_id, i, 0, 0, level.width, level.height, format, static_cast<GLsizei>(level.size), data + level.offset);
+            }
+
+            glTextureParameteri(_id, GL_TEXTURE_WRAP_S, _wrap);
+            glTextureParameteri(_id, GL_TEXTURE_WRAP_T, _wrap);
+            glTextureParameteri(_id, GL_TEXTURE_MIN_FILTER, _min_filter);
+            glTextureParameteri(_id, GL_TEXTURE_MAG_FILTER, _mag_filter);
+            glTextureParameteri(_id, GL_TEXTURE_MAX_LEVEL, levels - 1);
+        }
+    public:
+        static GLenum toGL(BlockFormat format) {
+            switch (format) {
+                case BlockFormat::BC1:
+                    return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+                case BlockFormat::BC3:
+                    return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+                case BlockFormat::BC5:
+                    return GL_COMPRESSED_RG_RGTC2;
+                case BlockFormat::BC7:
+                    return GL_COMPRESSED_RGBA_BPTC_UNORM;
+                default:
+                    return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+            }
+        }
+
+        Texture2D(const unsigned char* texture, const glm::vec2& size, const unsigned int channels, const GLenum wrap = GL_REPEAT, const GLenum min_filter = GL_LINEAR_MIPMAP_LINEAR, const GLenum mag_filter = GL_LINEAR)
+            : _wrap(wrap), _min_filter(min_filter), _mag_filter(mag_filter) {
+            create(texture, size, channels);
+        }
+
+        Texture2D(const CompressedImage& image, const GLenum wrap = GL_REPEAT, const GLenum min_filter = GL_LINEAR_MIPMAP_LINEAR, const GLenum mag_filter = GL_LINEAR)
+            : _wrap(wrap), _min_filter(min_filter), _mag_filter(mag_filter) {
+            create(image, image.data.data());
+        }
+
+        /// Replaces the image, e.g. when a placeholder's real pixels arrive. Storage is immutable, so the texture gets a new ID
+        void upload(const unsigned char* texture, const glm::vec2& size, const unsigned int channels) {
+            glDeleteTextures(1, &_id);
+            create(texture, size, channels);
+        }
+
+        /// Same as upload() but reads the pixels from `offset` in a pixel unpack buffer, so the driver copies them without stalling
+        void upload(GLuint pixel_buffer, size_t offset, const glm::vec2& size, const unsigned int channels) {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixel_buffer);
+            upload(reinterpret_cast<const unsigned char*>(offset), size, channels);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        }
+
+        void upload(const CompressedImage& image) {
+            glDeleteTextures(1, &_id);
+            create(image, image.data.data());
+        }
+
+        /// Compressed upload from a pixel unpack buffer holding `image.data` at `offset`
+        void upload(const CompressedImage& image, GLuint pixel_buffer, size_t offset) {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixel_buffer);
+            glDeleteTextures(1, &_id);
+            create(image, reinterpret_cast<const unsigned char*>(offset));
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        }
+
         ~Texture2D() {
             glDeleteTextures(1, &_id);
         }
 
+        GLuint getID() const {
+            return _id;
+        }
+
         void bind(int unit = 0) const {
             glBindTextureUnit(unit, _id);
         }
@@ -52,14 +140,17 @@ namespace Novo {
         }
 
         void setMinFilter(GLenum filter) {
+            _min_filter = filter;
             glTextureParameteri(_id, GL_TEXTURE_MIN_FILTER, filter);
         }
 
         void setMagFilter(GLenum filter) {
+            _mag_filter = filter;
             glTextureParameteri(_id, GL_TEXTURE_MAG_FILTER, filter);
         }
 
         void setWrap(GLenum wrap) {
+            _wrap = wrap;
             glTextureParameteri(_id, GL_TEXTURE_WRAP_S, wrap);
             glTextureParameteri(_id, GL_TEXTURE_WRAP_T, wrap);
         }
@@ -4,55 +4,103 @@
 #include <novo-core/VBO.hpp>
 #include <novo-core/IBO.hpp>
 
+#include <vector>
+
 namespace Novo {
+    /// Vertex format set up with direct state access. Every addVBO() gets its own binding point, so the buffer behind
+    /// a binding can be swapped with setVertexBuffer() while the attribute format stays
     class VAO {
     private:
         GLuint _id;
         GLuint _elCount = 0;
         GLuint _indCount = 0;
+        std::vector<GLsizei> _strides; // Per binding point
+
+        /// Vertex array bound through this class, 0 if unknown
+        static GLuint& current() {
+            static GLuint s_current = 0;
+            return s_current;
+        }
     public:
         VAO() {
-            glGenVertexArrays(1, &_id);
+            glCreateVertexArrays(1, &_id);
         }
 
         ~VAO() {
+            if (current() == _id) current() = 0;
             glDeleteVertexArrays(1, &_id);
         }
 
+        VAO(const VAO&) = delete;
+        VAO& operator=(const VAO&) = delete;
+
+        GLuint getID() const {
+            return _id;
+        }
+
+        /// Binds `vao` unless it is already bound
+        /// @return true if glBindVertexArray was called
+        static bool bind(GLuint vao) {
+            if (current() == vao) return false;
+            glBindVertexArray(vao);
+            current() = vao;
+            return true;
+        }
+
         void bind() {
-            glBindVertexArray(_id);
+            bind(_id);
         }
 
         static void unbind() {
-            glBindVertexArray(0);
+            bind(0);
         }
 
-        void addVBO(VBO& vbo) {
-            bind();
-            vbo.bind();
-
-            for (auto& element : vbo.get_layout().get_elements()) {
-                glVertexAttribPointer(
-                    _elCount,
-                    element.components_count,
-                    element.component_type,
-                    GL_FALSE,
-                    vbo.get_layout().get_stride(),
-                    reinterpret_cast<void*>(element.offset)
-                );
-                glEnableVertexAttribArray(_elCount);
-                ++_elCount;
+        /// Forgets the tracked binding, call when code outside this class may have bound a vertex array
+        static void invalidate() {
+            current() = ~0u;
+        }
+
+        /// Adds the attributes of `layout` after the existing ones, read from a new binding point without a buffer yet
+        /// @return the binding point, attach buffers with setVertexBuffer()
+        GLuint addLayout(const BufferLayout& layout) {
+            const GLuint binding = static_cast<GLuint>(_strides.size());
+
+            for (auto& element : layout.get_elements()) {
+                const size_t columns = get_columns(element.type);
+                for (size_t column = 0; column < columns; ++column) {
+                    glEnableVertexArrayAttrib(_id, _elCount);
+                    glVertexArrayAttribFormat(
+                        _id,
+                        _elCount,
+                        static_cast<GLint>(element.components_count / columns),
+                        element.component_type,
+                        GL_FALSE,
+                        static_cast<GLuint>(element.offset + column * element.size / columns)
+                    );
+                    glVertexArrayAttribBinding(_id, _elCount, binding);
+                    ++_elCount;
+                }
             }
+            glVertexArrayBindingDivisor(_id, binding, layout.get_divisor());
+
+            _strides.push_back(static_cast<GLsizei>(layout.get_stride()));
+            return binding;
+        }
+
+        void addVBO(VBO& vbo) {
+            setVertexBuffer(addLayout(vbo.get_layout()), vbo);
+        }
+
+        /// Points binding `binding` at `vbo`, which must have the layout the binding was added with
+        void setVertexBuffer(GLuint binding, const VBO& vbo) {
+            glVertexArrayVertexBuffer(_id, binding, vbo.getID(), 0, _strides[binding]);
         }
 
         void setIBO(IBO& ibo) {
-            bind();
-            ibo.bind();
+            glVertexArrayElementBuffer(_id, ibo.getID());
             _indCount = ibo.get_count();
-
-            
         }
-        
+
         size_t getIndCount() const {
             return _indCount;
         }
@@ -65,5 +113,10 @@ namespace Novo {
                 glDrawArrays(method, 0, _elCount);
             }
         }
+
+        void draw_instanced(GLsizei instances, GLenum method = GL_TRIANGLES) {
+            bind();
+            glDrawElementsInstanced(method, _indCount, GL_UNSIGNED_INT, nullptr, instances);
+        }
     };
-}
\ No newline at end of file
+}
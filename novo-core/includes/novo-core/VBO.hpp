@@ -2,6 +2,7 @@
 
 #include <glad/glad.h>
 #include <iostream>
+#include <vector>
 
 namespace Novo {
     enum class ShaderDataType {
@@ -9,6 +10,7 @@ namespace Novo {
         Float2,     Int2,
         Float3,     Int3,
         Float4,     Int4,
+        Mat3,       Mat4,
     };
 
     constexpr size_t get_count(ShaderDataType type) {
@@ -25,10 +27,26 @@ namespace Novo {
             case ShaderDataType::Int4:
             case ShaderDataType::Float4:
                 return 4;
+            case ShaderDataType::Mat3:
+                return 3 * 3;
+            case ShaderDataType::Mat4:
+                return 4 * 4;
         }
         return 0;
     }
 
+    /// Number of attribute locations the type occupies. Matrices take one location per column
+    constexpr size_t get_columns(ShaderDataType type) {
+        switch (type) {
+            case ShaderDataType::Mat3:
+                return 3;
+            case ShaderDataType::Mat4:
+                return 4;
+            default:
+                return 1;
+        }
+    }
+
     constexpr size_t get_size(ShaderDataType type) {
         switch (type) {
             case ShaderDataType::Int:
@@ -40,6 +58,8 @@ namespace Novo {
             case ShaderDataType::Float2:
             case ShaderDataType::Float3:
             case ShaderDataType::Float4:
+            case ShaderDataType::Mat3:
+            case ShaderDataType::Mat4:
                 return sizeof(GLfloat) * get_count(type);
         }
         return 0;
@@ -56,6 +76,8 @@ namespace Novo {
             case ShaderDataType::Float2:
             case ShaderDataType::Float3:
             case ShaderDataType::Float4:
+            case ShaderDataType::Mat3:
+            case ShaderDataType::Mat4:
                 return GL_FLOAT;
         }
         return 0;
@@ -80,9 +102,11 @@ namespace Novo {
     private:
         std::vector<BufferElement> _elements;
         size_t _stride;
+        GLuint _divisor;
     public:
-        BufferLayout(std::initializer_list<BufferElement> elements)
-         : _elements(std::move(elements)) {
+        /// @param divisor 0 - advance per vertex, N - advance once every N instances
+        BufferLayout(std::initializer_list<BufferElement> elements, GLuint divisor = 0)
+         : _elements(std::move(elements)), _divisor(divisor) {
             size_t offset = 0;
             _stride = 0;
             for (auto& element : _elements) {
@@ -99,12 +123,31 @@ namespace Novo {
         size_t get_stride() const {
             return _stride;
         }
+
+        GLuint get_divisor() const {
+            return _divisor;
+        }
+
+        bool operator==(const BufferLayout& other) const {
+            if (_divisor != other._divisor || _elements.size() != other._elements.size()) return false;
+            for (size_t i = 0; i < _elements.size(); ++i) {
+                if (_elements[i].type != other._elements[i].type) return false;
+            }
+            return true;
+        }
     };
 
     class VBO {
     private:
         GLuint _id;
         BufferLayout _layout;
+        size_t _size;
+        GLenum _usage;
+
+        /// Gives dynamic and stream buffers fresh storage, so a full rewrite doesn't wait for draws still reading the old contents
+        void orphan() {
+            if (_usage != GL_STATIC_DRAW) glNamedBufferData(_id, _size, nullptr, _usage);
+        }
     public:
         enum class Mode {
             STATIC,
@@ -125,16 +168,19 @@ namespace Novo {
             }
         }
 
-        public: VBO(void* data, const size_t size, BufferLayout layout, Mode mode = Mode::STATIC) : _layout(layout) {
-            glGenBuffers(1, &_id);
-            glBindBuffer(GL_ARRAY_BUFFER, _id);
-            glBufferData(GL_ARRAY_BUFFER, size, data, modeToGL(mode));
+        public: VBO(const void* data, const size_t size, BufferLayout layout, Mode mode = Mode::STATIC) : _layout(layout), _size(size), _usage(modeToGL(mode)) {
+            glCreateBuffers(1, &_id);
+            glNamedBufferData(_id, size, data, _usage);
         }
 
         ~VBO() {
             glDeleteBuffers(1, &_id);
         }
 
+        GLuint getID() const {
+            return _id;
+        }
+
         void bind() {
             glBindBuffer(GL_ARRAY_BUFFER, _id);
         }
@@ -143,8 +189,39 @@ namespace Novo {
             glBindBuffer(GL_ARRAY_BUFFER, 0);
         }
 
+        /// Overwrites `size` bytes starting at `offset` without reallocating the buffer
+        void update(const size_t offset, const void* data, const size_t size) {
+            glNamedBufferSubData(_id, offset, size, data);
+        }
+
+        /// Copies `size` bytes already written to a staging buffer into the VBO on the GPU
+        void update(const size_t offset, GLuint staging_buffer, const size_t staging_offset, const size_t size) {
+            glCopyNamedBufferSubData(staging_buffer, _id, staging_offset, offset, size);
+        }
+
+        /// Replaces the contents with `size` bytes, anything past them is undefined afterwards
+        void replace(const void* data, const size_t size) {
+            orphan();
+            update(0, data, size);
+        }
+
+        void replace(GLuint staging_buffer, const size_t staging_offset, const size_t size) {
+            orphan();
+            update(0, staging_buffer, staging_offset, size);
+        }
+
+        /// Reallocates the storage under the same buffer name, so VAOs reading from it stay valid. Contents are lost
+        void resize(const size_t size) {
+            _size = size;
+            glNamedBufferData(_id, size, nullptr, _usage);
+        }
+
         BufferLayout get_layout() const {
             return _layout;
         }
+
+        size_t get_size() const {
+            return _size;
+        }
     };
 }
\ No newline at end of file
@@ -49,6 +49,10 @@ namespace Novo {
             glfwWindowHint(GLFW_MAXIMIZED, 0);
 
             _win = glfwCreateWindow(size.x, size.y, title.c_str(), nullptr, nullptr);
+            if (!_win) { // 4.3 is enough for everything but multi-draw, which the renderer turns off by itself
+                glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+                _win = glfwCreateWindow(size.x, size.y, title.c_str(), nullptr, nullptr);
+            }
             _size = size;
             _title = title;
 
@@ -127,6 +131,11 @@ namespace Novo {
             glViewport(0, 0, _size.x, _size.y);
         }
 
+        /// Replaces the default callback, which only calls setSize(). Replacements should call it too
+        void setSizeCallback(std::function<void(Window&, glm::vec2)> callback) {
+            _size_callback = std::move(callback);
+        }
+
         void setTitle(const std::string& title) {
             _title = title;
             glfwSetWindowTitle(_win, _title.c_str());
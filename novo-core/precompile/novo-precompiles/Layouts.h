@@ -82,8 +82,19 @@ namespace Novo {
             ShaderDataType::Float2 // Texture (UV)
         };
 
-        static BufferLayout create(const std::initializer_list<BufferElement>& types) {
-            return BufferLayout(std::move(types));
+        const static BufferLayout l_instance = BufferLayout({
+            ShaderDataType::Mat4,   // Model matrix
+            ShaderDataType::Float2, // UV scale
+            ShaderDataType::Mat3    // Normal matrix
+        }, 1);
+
+        const static BufferLayout l_light_instance = BufferLayout({
+            ShaderDataType::Mat4,   // Model matrix
+            ShaderDataType::Float3  // Light color
+        }, 1);
+
+        static BufferLayout create(const std::initializer_list<BufferElement>& types, GLuint divisor = 0) {
+            return BufferLayout(std::move(types), divisor);
         }
     }
 }
\ No newline at end of file
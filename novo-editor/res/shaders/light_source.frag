@@ -1,9 +1,9 @@
 #version 460
 
-out vec4 frag_color;
+in vec3 gizmo_color;
 
-uniform vec3 light_color;
+out vec4 frag_color;
 
 void main() {
-    frag_color = vec4(light_color, 1.0);
+    frag_color = vec4(gizmo_color, 1.0);
 }
\ No newline at end of file
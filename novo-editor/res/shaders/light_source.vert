@@ -2,10 +2,18 @@
 layout(location = 0) in vec3 vertex_positon;
 layout(location = 1) in vec3 vertex_normal;
 layout(location = 2) in vec2 texture_coord;
+layout(location = 3) in mat4 instance_model; // Locations 3-6
+layout(location = 7) in vec3 instance_color;
 
+out vec3 gizmo_color;
+
+uniform bool instanced; // Take model and light_color from instance attributes instead of uniforms
 uniform mat4 model;
 uniform mat4 view_projection;
+uniform vec3 light_color;
 
 void main() {
-    gl_Position =  view_projection * model * vec4(vertex_positon * 0.1f, 1.0);
+    mat4 model_matrix = instanced ? instance_model : model;
+    gizmo_color = instanced ? instance_color : light_color;
+    gl_Position =  view_projection * model_matrix * vec4(vertex_positon * 0.1f, 1.0);
 };
\ No newline at end of file
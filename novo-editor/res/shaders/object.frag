@@ -3,15 +3,45 @@
 in vec2 tex_coord;
 in vec3 frag_normal;
 in vec3 frag_position;
+flat in int draw_index;
 
 layout(binding = 0) uniform sampler2D InTexture;
 
 out vec4 frag_color;
 
-#define MAX_LIGHTS 256
+struct Light {
+    vec4 position;
+    vec4 color;
+};
 
-uniform vec3 light_colors[MAX_LIGHTS];
-uniform vec3 light_positions[MAX_LIGHTS];
+layout(std430, binding = 0) readonly buffer LightBuffer {
+    vec4 ambient_color;
+    uint light_count;
+    Light lights[];
+};
+
+layout(std430, binding = 1) readonly buffer ClusterGrid {
+    uvec4 grid_size;
+    vec4 z_params;    // x - slice scale, y - slice bias
+    vec4 screen_size;
+    mat4 view;
+    uvec2 clusters[]; // x - offset into light_indices, y - light count
+};
+
+layout(std430, binding = 2) readonly buffer ClusterLights {
+    uint light_indices[];
+};
+
+struct DrawData {
+    float ambient_factor;
+    float diffuse_factor;
+    float specular_factor;
+    float shininess;
+};
+
+layout(std430, binding = 3) readonly buffer DrawBuffer {
+    DrawData draws[];
+};
 
 uniform vec3 camera_position;
 
@@ -19,32 +49,51 @@ uniform float ambient_factor;
 uniform float diffuse_factor;
 uniform float specular_factor;
 uniform float shininess;
+uniform bool indirect; // Material factors come from draws[draw_index] instead of the uniforms
+
+uint cluster_index() {
+    float depth = -(view * vec4(frag_position, 1.0)).z;
+    uint slice = uint(max(log(depth) * z_params.x + z_params.y, 0.0));
+    uvec2 tile = uvec2(gl_FragCoord.xy / screen_size.xy * vec2(grid_size.xy));
+
+    tile = min(tile, grid_size.xy - 1);
+    slice = min(slice, grid_size.z - 1);
+    return tile.x + grid_size.x * (tile.y + grid_size.y * slice);
+}
 
 void main() {
-    vec3 total_ambient = vec3(0);
+    DrawData material = indirect ? draws[draw_index] : DrawData(ambient_factor, diffuse_factor, specular_factor, shininess);
+
+    // Ambient
+    vec3 total_ambient = material.ambient_factor * ambient_color.rgb;
     vec3 total_diffuse = vec3(0);
     vec3 total_specular = vec3(0);
 
     vec3 normal = normalize(frag_normal);
+    vec3 view_dir = normalize(camera_position - frag_position);
 
-    for (int i = 0; i < MAX_LIGHTS; ++i) {
-        if (length(light_colors[i]) == 0.0) continue;
+    uvec2 cluster = clusters[cluster_index()];
+    for (uint i = 0; i < cluster.y; ++i) {
+        Light light = lights[light_indices[cluster.x + i]];
+        vec3 light_position = light.position.xyz;
+        vec3 light_color = light.color.rgb;
+        float light_radius = light.position.w;
 
-        vec3 light_dir = normalize(light_positions[i] - frag_position);
-        float distance = length(light_positions[i] - frag_position);
-        float distance_factor = 1.0 / (distance * distance);
+        vec3 light_dir = normalize(light_position - frag_position);
+        float distance = length(light_position - frag_position);
 
-        // Ambient
-        total_ambient += ambient_factor * light_colors[i];
+        // Fades to zero at the light radius so culled clusters don't show a seam
+        float range_factor = clamp(1.0 - pow(distance / light_radius, 4.0), 0.0, 1.0);
+        range_factor *= range_factor;
+        float distance_factor = range_factor / (distance * distance);
 
         // Diffuse
-        total_diffuse += distance_factor * diffuse_factor * light_colors[i] * max(dot(normal, light_dir), 0.0);
+        total_diffuse += distance_factor * material.diffuse_factor * light_color * max(dot(normal, light_dir), 0.0);
 
         // Specular
-        vec3 view_dir = normalize(camera_position - frag_position);
         vec3 reflect_dir = reflect(-light_dir, normal);
-        float specular_value = pow(max(dot(view_dir, reflect_dir), 0.0), shininess);
-        total_specular += specular_factor * specular_value * light_colors[i];
+        float specular_value = pow(max(dot(view_dir, reflect_dir), 0.0), material.shininess);
+        total_specular += range_factor * material.specular_factor * specular_value * light_color;
     }
 
     frag_color = texture(InTexture, tex_coord) * vec4(total_ambient + total_diffuse + total_specular, 1.f);
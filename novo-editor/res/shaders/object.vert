@@ -2,18 +2,35 @@
 layout(location = 0) in vec3 vertex_positon;
 layout(location = 1) in vec3 vertex_normal;
 layout(location = 2) in vec2 texture_coord;
+layout(location = 3) in mat4 instance_model;    // Locations 3-6
+layout(location = 7) in vec2 instance_uv_scale;
+layout(location = 8) in mat3 instance_normal_matrix; // Locations 8-10
 
 out vec2 tex_coord;
 out vec3 frag_normal;
 out vec3 frag_position;
+flat out int draw_index;
 
+uniform bool instanced; // Take model, normal_matrix and uv_scale from instance attributes instead of uniforms
 uniform mat4 model;
+uniform mat3 normal_matrix; // transpose(inverse(mat3(model))), computed on the CPU
 uniform mat4 view_projection;
+uniform vec2 uv_scale;
+uniform int draw_base; // First command of the current glMultiDrawElementsIndirect call
 
 void main() {
-    vec4 v_pos_world = model * vec4(vertex_positon, 1.0);
-    tex_coord = texture_coord;
-    frag_normal = mat3(transpose(inverse(model))) * vertex_normal;
+    mat4 model_matrix = instanced ? instance_model : model;
+    mat3 normal_model = instanced ? instance_normal_matrix : normal_matrix;
+    vec2 uv = instanced ? instance_uv_scale : uv_scale;
+
+    vec4 v_pos_world = model_matrix * vec4(vertex_positon, 1.0);
+    tex_coord = texture_coord * uv;
+    frag_normal = normal_model * vertex_normal;
     frag_position = v_pos_world.xyz;
+#ifdef NOVO_DRAW_ID
+    draw_index = draw_base + NOVO_DRAW_ID;
+#else
+    draw_index = draw_base; // No draw ids, so no multi-draws either and draw_index is never read
+#endif
     gl_Position =  view_projection * v_pos_world;
 };
\ No newline at end of file
@@ -11,6 +11,7 @@ class NovoEditor : public Novo::Application {
 private:
     std::unique_ptr<Novo::Window> p_window = nullptr;
     std::shared_ptr<Novo::Resources> p_resources = nullptr;
+    std::shared_ptr<Novo::JobSystem> p_jobs = nullptr;
     std::unique_ptr<Debugger> p_debugger = nullptr;
 
     std::shared_ptr<Novo::Camera> p_camera = nullptr;
@@ -37,11 +38,17 @@ public:
         p_window = std::make_unique<Novo::Window>("Novo", glm::vec2(1920, 1080));
         p_window->setMaximized(true);
 
-        p_resources = std::make_shared<Novo::Resources>(argv[0]);
+        p_jobs = std::make_shared<Novo::JobSystem>();
+        p_resources = std::make_shared<Novo::Resources>(argv[0], p_jobs);
         p_camera = std::make_shared<Novo::Camera>(c_pos, c_rot, Novo::Camera::CameraType::Perspective, c_fov, p_window->getAspectRatio());
         Novo::CurrentCamera::set_camera(p_camera);
         p_debugger = std::make_unique<Debugger>(*p_window);
-        p_scene = std::make_unique<Novo::Scene>(p_resources);
+        p_scene = std::make_unique<Novo::Scene>(p_resources, p_jobs);
+        p_scene->set_viewport_size(p_window->getSize());
+        p_window->setSizeCallback([this](Novo::Window& window, glm::vec2 size) {
+            window.setSize(size);
+            p_scene->set_viewport_size(size);
+        });
         
         p_scene->load_from_json("res/scenes/empty.json");
         p_scene->reload_all();
@@ -55,6 +62,7 @@ public:
             glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
             p_scene->render();
+            p_jobs->run_main_jobs(std::chrono::milliseconds(2));
 
             key_pressed();
             debug();
@@ -0,0 +1,72 @@
+#include <novo-core/SceneFile.hpp>
+#include <novo-core/MappedFile.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using Json = nlohmann::json;
+
+bool json_to_binary(const std::string& input, const std::string& output) {
+    std::ifstream file(input);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open file " << input << std::endl;
+        return false;
+    }
+
+    Json json = Json::parse(file, nullptr, false);
+    if (json.is_discarded()) {
+        std::cerr << "Invalid JSON in " << input << std::endl;
+        return false;
+    }
+
+    Novo::SceneFile::Writer writer;
+    Novo::SceneFile::from_json(json, writer);
+    return writer.write(output);
+}
+
+bool binary_to_json(const std::string& input, const std::string& output) {
+    Novo::MappedFile file(input);
+    if (!file.is_open()) return false;
+
+    const Novo::SceneFile::View view(file.get_data(), file.get_size());
+    if (!view.is_valid()) {
+        std::cerr << "Invalid or unsupported scene file " << input << std::endl;
+        return false;
+    }
+
+    std::ofstream out(output);
+    if (!out.is_open()) {
+        std::cerr << "Failed to open file " << output << std::endl;
+        return false;
+    }
+    out << Novo::SceneFile::to_json(view).dump(4) << std::endl;
+    return static_cast<bool>(out);
+}
+
+// Converts scenes between the JSON format and the binary .nvscene format, the direction follows the input extension.
+// Usage: novo-sceneconv <input> [output]
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: novo-sceneconv <input.json|input.nvscene> [output]" << std::endl;
+        return 1;
+    }
+
+    const std::filesystem::path input = argv[1];
+    const bool to_binary = input.extension() != ".nvscene";
+
+    std::filesystem::path output = input;
+    if (argc >= 3) {
+        output = argv[2];
+    } else {
+        output.replace_extension(to_binary ? ".nvscene" : ".json");
+    }
+
+    const bool converted = to_binary ? json_to_binary(input.string(), output.string()) : binary_to_json(input.string(), output.string());
+    if (converted) {
+        std::cout << input.string() << " -> " << output.string() << std::endl;
+    }
+    return converted ? 0 : 1;
+}
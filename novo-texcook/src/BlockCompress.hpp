@@ -0,0 +1,239 @@
+#pragma once
+
+#include <novo-core/CompressedImage.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+/// Simple block encoders for BC1, BC3 and BC5. Colour endpoints are fitted along the principal axis of the block,
+/// which is fast and good enough for albedo textures. BC7 is not encoded, only loaded from files built by other tools
+namespace BlockCompress {
+    struct Block {
+        uint8_t pixels[16][4]; // RGBA, row by row
+    };
+
+    /// Copies the 4x4 block at (`x`, `y`) of an RGBA image, edge pixels are repeated for blocks crossing the border
+    inline Block fetch_block(const unsigned char* rgba, uint32_t width, uint32_t height, uint32_t x, uint32_t y) {
+        Block block;
+        for (uint32_t j = 0; j < 4; ++j) {
+            for (uint32_t i = 0; i < 4; ++i) {
+                const uint32_t px = std::min(x + i, width - 1);
+                const uint32_t py = std::min(y + j, height - 1);
+                std::memcpy(block.pixels[j * 4 + i], rgba + (size_t(py) * width + px) * 4, 4);
+            }
+        }
+        return block;
+    }
+
+    inline uint16_t to_565(const float color[3]) {
+        const int r = std::clamp(int(std::lround(color[0] * 31.f / 255.f)), 0, 31);
+        const int g = std::clamp(int(std::lround(color[1] * 63.f / 255.f)), 0, 63);
+        const int b = std::clamp(int(std::lround(color[2] * 31.f / 255.f)), 0, 31);
+        return uint16_t(r << 11 | g << 5 | b);
+    }
+
+    inline void from_565(uint16_t color, int out[3]) {
+        const int r = color >> 11 & 31, g = color >> 5 & 63, b = color & 31;
+        out[0] = r << 3 | r >> 2;
+        out[1] = g << 2 | g >> 4;
+        out[2] = b << 3 | b >> 2;
+    }
+
+    /// Picks the closest of the four palette colours for every pixel
+    /// @return squared error of the block
+    inline int fit_indices(const Block& block, uint16_t c0, uint16_t c1, uint32_t& indices) {
+        indices = 0;
+        int palette[4][3];
+        from_565(c0, palette[0]);
+        from_565(c1, palette[1]);
+        for (int c = 0; c < 3; ++c) {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+
+        int total = 0;
+        for (int i = 0; i < 16; ++i) {
+            int best = 0, best_error = 1 << 30;
+            for (int p = 0; p < (c0 == c1 ? 1 : 4); ++p) {
+                int error = 0;
+                for (int c = 0; c < 3; ++c) {
+                    const int d = block.pixels[i][c] - palette[p][c];
+                    error += d * d;
+                }
+                if (error < best_error) {
+                    best_error = error;
+                    best = p;
+                }
+            }
+            indices |= uint32_t(best) << (2 * i);
+            total += best_error;
+        }
+        return total;
+    }
+
+    /// 8 byte colour block, always in four colour mode as BC3 requires
+    inline void encode_color(const Block& block, uint8_t* out) {
+        float mean[3] = {};
+        for (const auto& pixel : block.pixels) {
+            for (int c = 0; c < 3; ++c) mean[c] += pixel[c] / 16.f;
+        }
+
+        float covariance[6] = {}; // rr, rg, rb, gg, gb, bb
+        for (const auto& pixel : block.pixels) {
+            const float d[3] = { pixel[0] - mean[0], pixel[1] - mean[1], pixel[2] - mean[2] };
+            covariance[0] += d[0] * d[0]; covariance[1] += d[0] * d[1]; covariance[2] += d[0] * d[2];
+            covariance[3] += d[1] * d[1]; covariance[4] += d[1] * d[2]; covariance[5] += d[2] * d[2];
+        }
+
+        // Power iteration for the principal axis
+        float axis[3] = { 1.f, 1.f, 1.f };
+        for (int iteration = 0; iteration < 8; ++iteration) {
+            const float next[3] = {
+                covariance[0] * axis[0] + covariance[1] * axis[1] + covariance[2] * axis[2],
+                covariance[1] * axis[0] + covariance[3] * axis[1] + covariance[4] * axis[2],
+                covariance[2] * axis[0] + covariance[4] * axis[1] + covariance[5] * axis[2],
+            };
+            const float length = std::max({ std::fabs(next[0]), std::fabs(next[1]), std::fabs(next[2]) });
+            if (length < 1e-6f) break;
+            for (int c = 0; c < 3; ++c) axis[c] = next[c] / length;
+        }
+
+        float min_t = 1e30f, max_t = -1e30f;
+        for (const auto& pixel : block.pixels) {
+            const float t = (pixel[0] - mean[0]) * axis[0] + (pixel[1] - mean[1]) * axis[1] + (pixel[2] - mean[2]) * axis[2];
+            min_t = std::min(min_t, t);
+            max_t = std::max(max_t, t);
+        }
+
+        const float axis_length2 = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+        float high[3], low[3];
+        for (int c = 0; c < 3; ++c) {
+            high[c] = mean[c] + axis[c] * max_t / std::max(axis_length2, 1e-6f);
+            low[c] = mean[c] + axis[c] * min_t / std::max(axis_length2, 1e-6f);
+        }
+
+        uint16_t c0 = to_565(high), c1 = to_565(low);
+        if (c0 < c1) std::swap(c0, c1);
+        uint32_t indices = 0;
+        int error = fit_indices(block, c0, c1, indices);
+
+        // Least squares refit of the endpoints to the chosen indices, kept only if it lowers the error
+        for (int iteration = 0; iteration < 2 && c0 != c1; ++iteration) {
+            static const float weights[4] = { 1.f, 0.f, 2.f / 3.f, 1.f / 3.f }; // Weight of c0 per index
+            float aa = 0.f, ab = 0.f, bb = 0.f, ax[3] = {}, bx[3] = {};
+            for (int i = 0; i < 16; ++i) {
+                const float a = weights[indices >> (2 * i) & 3], b = 1.f - a;
+                aa += a * a; ab += a * b; bb += b * b;
+                for (int c = 0; c < 3; ++c) {
+                    ax[c] += a * block.pixels[i][c];
+                    bx[c] += b * block.pixels[i][c];
+                }
+            }
+            const float determinant = aa * bb - ab * ab;
+            if (std::fabs(determinant) < 1e-6f) break;
+
+            float fitted_high[3], fitted_low[3];
+            for (int c = 0; c < 3; ++c) {
+                fitted_high[c] = (ax[c] * bb - bx[c] * ab) / determinant;
+                fitted_low[c] = (bx[c] * aa - ax[c] * ab) / determinant;
+            }
+            uint16_t r0 = to_565(fitted_high), r1 = to_565(fitted_low);
+            if (r0 < r1) std::swap(r0, r1);
+
+            uint32_t refit_indices = 0;
+            const int refit_error = fit_indices(block, r0, r1, refit_indices);
+            if (refit_error >= error) break;
+            c0 = r0;
+            c1 = r1;
+            indices = refit_indices;
+            error = refit_error;
+        }
+
+        out[0] = uint8_t(c0); out[1] = uint8_t(c0 >> 8);
+        out[2] = uint8_t(c1); out[3] = uint8_t(c1 >> 8);
+        for (int i = 0; i < 4; ++i) out[4 + i] = uint8_t(indices >> (8 * i));
+    }
+
+    /// 8 byte single channel block (BC4 layout), used for BC3 alpha and both BC5 channels
+    inline void encode_channel(const Block& block, int channel, uint8_t* out) {
+        int high = 0, low = 255;
+        for (const auto& pixel : block.pixels) {
+            high = std::max<int>(high, pixel[channel]);
+            low = std::min<int>(low, pixel[channel]);
+        }
+
+        uint64_t indices = 0;
+        if (high != low) {
+            // Eight value mode: 0 - high, 1 - low, 2..7 - interpolated from high to low
+            int palette[8] = { high, low };
+            for (int p = 2; p < 8; ++p) {
+                palette[p] = ((8 - p) * high + (p - 1) * low) / 7;
+            }
+            for (int i = 0; i < 16; ++i) {
+                int best = 0, best_error = 1 << 30;
+                for (int p = 0; p < 8; ++p) {
+                    const int error = std::abs(block.pixels[i][channel] - palette[p]);
+                    if (error < best_error) {
+                        best_error = error;
+                        best = p;
+                    }
+                }
+                indices |= uint64_t(best) << (3 * i);
+            }
+        }
+
+        out[0] = uint8_t(high);
+        out[1] = uint8_t(low);
+        for (int i = 0; i < 6; ++i) out[2 + i] = uint8_t(indices >> (8 * i));
+    }
+
+    /// Encodes one mip level of an RGBA image into `out`, which must hold CompressedImage::get_level_size() bytes
+    inline void encode(Novo::BlockFormat format, const unsigned char* rgba, uint32_t width, uint32_t height, uint8_t* out) {
+        for (uint32_t y = 0; y < height; y += 4) {
+            for (uint32_t x = 0; x < width; x += 4) {
+                const Block block = fetch_block(rgba, width, height, x, y);
+                switch (format) {
+                    case Novo::BlockFormat::BC1:
+                        encode_color(block, out);
+                        out += 8;
+                        break;
+                    case Novo::BlockFormat::BC3:
+                        encode_channel(block, 3, out);
+                        encode_color(block, out + 8);
+                        out += 16;
+                        break;
+                    case Novo::BlockFormat::BC5:
+                        encode_channel(block, 0, out);
+                        encode_channel(block, 1, out + 8);
+                        out += 16;
+                        break;
+                    default:
+                        break;
+                }
+            }
+        }
+    }
+
+    /// Halves an RGBA image with a 2x2 box filter, odd edges repeat the last row or column
+    inline std::vector<unsigned char> downsample(const std::vector<unsigned char>& rgba, uint32_t width, uint32_t height) {
+        const uint32_t out_width = std::max(width / 2, 1u);
+        const uint32_t out_height = std::max(height / 2, 1u);
+        std::vector<unsigned char> out(size_t(out_width) * out_height * 4);
+
+        for (uint32_t y = 0; y < out_height; ++y) {
+            for (uint32_t x = 0; x < out_width; ++x) {
+                const uint32_t x0 = std::min(x * 2, width - 1), x1 = std::min(x * 2 + 1, width - 1);
+                const uint32_t y0 = std::min(y * 2, height - 1), y1 = std::min(y * 2 + 1, height - 1);
+                for (int c = 0; c < 4; ++c) {
+                    const int sum = rgba[(size_t(y0) * width + x0) * 4 + c] + rgba[(size_t(y0) * width + x1) * 4 + c]
+                                  + rgba[(size_t(y1) * width + x0) * 4 + c] + rgba[(size_t(y1) * width + x1) * 4 + c];
+                    out[(size_t(y) * out_width + x) * 4 + c] = uint8_t((sum + 2) / 4);
+                }
+            }
+        }
+        return out;
+    }
+}
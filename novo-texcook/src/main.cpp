@@ -0,0 +1,125 @@
+#define STB_IMAGE_IMPLEMENTATION
+#include <novo-core/stb_image.h>
+#include <novo-core/json.hpp>
+#include <novo-core/DDS.hpp>
+
+#include "BlockCompress.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+using Json = nlohmann::json;
+namespace fs = std::filesystem;
+
+bool parse_format(const std::string& name, Novo::BlockFormat& format) {
+    if (name == "bc1") format = Novo::BlockFormat::BC1;
+    else if (name == "bc3") format = Novo::BlockFormat::BC3;
+    else if (name == "bc5") format = Novo::BlockFormat::BC5;
+    else return false;
+    return true;
+}
+
+bool has_alpha(const unsigned char* rgba, size_t pixels) {
+    for (size_t i = 0; i < pixels; ++i) {
+        if (rgba[i * 4 + 3] != 255) return true;
+    }
+    return false;
+}
+
+bool cook(const fs::path& source, const fs::path& target, const std::string& compression) {
+    int width, height, channels;
+    stbi_set_flip_vertically_on_load(true); // Same orientation as Resources::loadTexture()
+    unsigned char* pixels = stbi_load(source.string().c_str(), &width, &height, &channels, 4);
+    if (!pixels) {
+        std::cerr << "Failed to load texture " << source << std::endl;
+        return false;
+    }
+    std::vector<unsigned char> level(pixels, pixels + size_t(width) * height * 4);
+    stbi_image_free(pixels);
+
+    Novo::BlockFormat format = has_alpha(level.data(), size_t(width) * height) ? Novo::BlockFormat::BC3 : Novo::BlockFormat::BC1;
+    if (!compression.empty() && !parse_format(compression, format)) {
+        std::cerr << "Unknown compression " << compression << " for " << source << std::endl;
+        return false;
+    }
+
+    const size_t mip_count = size_t(std::log2(std::max(width, height))) + 1;
+    Novo::CompressedImage image;
+    image.allocate(format, width, height, mip_count);
+
+    for (size_t i = 0; i < mip_count; ++i) {
+        const Novo::CompressedImage::Level& mip = image.levels[i];
+        BlockCompress::encode(format, level.data(), mip.width, mip.height, image.data.data() + mip.offset);
+        if (i + 1 < mip_count) {
+            level = BlockCompress::downsample(level, mip.width, mip.height);
+        }
+    }
+
+    if (!Novo::DDS::write(target.string(), image)) return false;
+
+    const size_t raw_size = size_t(width) * height * channels;
+    std::cout << source.generic_string() << " -> " << target.filename().string() << " (" << raw_size / 1024 << " KiB -> " << image.data.size() / 1024 << " KiB with mips)" << std::endl;
+    return true;
+}
+
+// Builds the .dds next to every texture referenced by the given scenes, Resources picks them up instead of the PNGs.
+// Usage: novo-texcook [--root <dir>] [--force] <scene.json>...
+// Texture entries may set "compression" to "bc1", "bc3" or "bc5", the default picks BC3 for images with alpha and BC1 otherwise
+int main(int argc, char** argv) {
+    fs::path root = fs::current_path();
+    bool force = false;
+    std::vector<std::string> scenes;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--root" && i + 1 < argc) {
+            root = argv[++i];
+        } else if (arg == "--force") {
+            force = true;
+        } else {
+            scenes.push_back(arg);
+        }
+    }
+
+    if (scenes.empty()) {
+        std::cerr << "Usage: novo-texcook [--root <dir>] [--force] <scene.json>..." << std::endl;
+        return 1;
+    }
+
+    std::set<std::string> cooked;
+    int failed = 0;
+    for (const std::string& scene : scenes) {
+        std::ifstream file(root / scene);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open scene " << root / scene << std::endl;
+            ++failed;
+            continue;
+        }
+
+        Json json = Json::parse(file, nullptr, false);
+        if (json.is_discarded() || !json.contains("textures")) continue;
+
+        for (const auto& texture : json["textures"]) {
+            const std::string path = texture["path"];
+            if (!cooked.insert(path).second) continue;
+
+            const fs::path source = root / path;
+            fs::path target = source;
+            target.replace_extension(".dds");
+            if (source.extension() == ".dds") continue;
+
+            std::error_code error;
+            if (!force && fs::exists(target, error) && fs::last_write_time(target, error) >= fs::last_write_time(source, error)) continue;
+
+            const std::string compression = texture.contains("compression") ? texture["compression"].get<std::string>() : std::string();
+            if (!cook(source, target, compression)) ++failed;
+        }
+    }
+
+    return failed == 0 ? 0 : 1;
+}